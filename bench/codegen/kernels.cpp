@@ -0,0 +1,117 @@
+/* 2021 Nikolai Chizhov */
+
+/* Code generation kernels
+ *
+ * Every tmpl_ function does with the register API what its raw_ pair does
+ *   with a CMSIS-style volatile struct. The object is compiled at several
+ *   optimization levels and tools/codegen_report.py compares the pairs in
+ *   the disassembly: the template version must not be larger or slower.
+ *
+ * The functions are extern "C" so the names in the disassembly are plain.
+ */
+
+#include <cstdint>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+#include "port.hpp"
+#include "pin.hpp"
+
+/* the reference: registers as a volatile struct, as CMSIS headers do */
+struct RawGpio {
+    volatile uint32_t CRL;
+    volatile uint32_t CRH;
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+    volatile uint32_t BSRR;
+    volatile uint32_t BRR;
+    volatile uint32_t LCKR;
+};
+
+struct RawUsart {
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+    volatile uint32_t BRR;
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t CR3;
+    volatile uint32_t GTPR;
+};
+
+static inline RawGpio *RawGpioB() {
+    return reinterpret_cast<RawGpio *>(GPIOB::CRL::Address);
+}
+
+static inline RawUsart *RawUsart1() {
+    return reinterpret_cast<RawUsart *>(USART1::SR::Address);
+}
+
+using Led = Pin<Port<GPIOB>, 5, PinMode::Allmighty>;
+
+/* Pin::Set, one BSRR store */
+extern "C" __attribute__((noinline, used))
+void tmpl_pin_set() {
+    Led::Set();
+}
+
+extern "C" __attribute__((noinline, used))
+void raw_pin_set() {
+    RawGpioB()->BSRR = 1U << 5;
+}
+
+/* Pin::Get, one IDR load */
+extern "C" __attribute__((noinline, used))
+uint32_t tmpl_pin_get() {
+    return Led::Get();
+}
+
+extern "C" __attribute__((noinline, used))
+uint32_t raw_pin_get() {
+    return (RawGpioB()->IDR >> 5) & 1U;
+}
+
+/* FieldValue::Set, a read-modify-write of a 2-bit field */
+extern "C" __attribute__((noinline, used))
+void tmpl_field_value_set() {
+    USART1::CR2::STOP::Stop2::Set();
+}
+
+extern "C" __attribute__((noinline, used))
+void raw_field_value_set() {
+    RawUsart1()->CR2 = (RawUsart1()->CR2 & ~(0b11U << 12)) | (0b10U << 12);
+}
+
+/* RegisterFieldSet::Set, one read-modify-write for four fields */
+extern "C" __attribute__((noinline, used))
+void tmpl_field_set_set() {
+    USART1::CR1Set<
+        USART1::CR1::UE::Enable,
+        USART1::CR1::M::Disable,
+        USART1::CR1::TE::Enable,
+        USART1::CR1::RE::Enable
+    >::Set();
+}
+
+extern "C" __attribute__((noinline, used))
+void raw_field_set_set() {
+    const uint32_t mask = (1U << 13) | (1U << 12) | (1U << 3) | (1U << 2);
+    const uint32_t value = (1U << 13) | (1U << 3) | (1U << 2);
+    RawUsart1()->CR1 = (RawUsart1()->CR1 & ~mask) | value;
+}
+
+/* Port::SetOutput, the pin number is known at run time only */
+extern "C" __attribute__((noinline, used))
+void tmpl_port_set_output(uint32_t pin) {
+    Port<GPIOB>::SetOutput<Utils::Sync::None>(pin);
+}
+
+extern "C" __attribute__((noinline, used))
+void raw_port_set_output(uint32_t pin) {
+    if (pin < 8U) {
+        RawGpioB()->CRL = (RawGpioB()->CRL & ~(0xFU << (pin * 4U))) |
+                          (0x3U << (pin * 4U));
+    } else {
+        RawGpioB()->CRH = (RawGpioB()->CRH & ~(0xFU << ((pin - 8U) * 4U))) |
+                          (0x3U << ((pin - 8U) * 4U));
+    }
+}
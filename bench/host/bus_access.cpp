@@ -0,0 +1,222 @@
+/* 2021 Nikolai Chizhov */
+
+/* Bus access report
+ *
+ * Runs the register API on the simulated bus and prints how many loads and
+ *   stores every call costs. Every call has its expected counts, a call that
+ *   costs more or less fails the run (ctest).
+ *
+ * Then the values: the pin and bus helpers are driven through the simulated
+ *   registers (Poke the inputs, Peek the outputs) and checked.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+#include "port.hpp"
+#include "pin.hpp"
+#include "pin_group.hpp"
+#include "port_bus.hpp"
+#include "debounce.hpp"
+#include "transaction.hpp"
+#include "board.hpp"
+
+using Led = Pin<Port<GPIOA>, 0, PinMode::Allmighty>;
+using Leds = PinGroup<
+    Pin<Port<GPIOA>, 0, PinMode::Write>,
+    Pin<Port<GPIOA>, 1, PinMode::Write>,
+    Pin<Port<GPIOA>, 2, PinMode::Write>,
+    Pin<Port<GPIOB>, 3, PinMode::Write>
+>;
+using Keys = PinGroup<
+    Pin<Port<GPIOA>, 4,  PinMode::Read>,
+    Pin<Port<GPIOA>, 5,  PinMode::Read>,
+    Pin<Port<GPIOC>, 0,  PinMode::Read>,
+    Pin<Port<GPIOB>, 15, PinMode::Read>,
+    Pin<Port<GPIOA>, 7,  PinMode::Read>
+>;
+using Data = PortBus<Port<GPIOB>, 4, 8>;    /* PB4..PB11, CRL and CRH */
+
+static bool failed = false;
+
+template <typename Func>
+static void Report(const char *name, uint32_t loads, uint32_t stores, Func func) {
+    SimBus::ResetCounters();
+    func();
+    const SimBus::Counters total = SimBus::GetTotal();
+    const bool expected = total.loads == loads && total.stores == stores;
+    std::printf("%-40s %6u %6u%s\n", name,
+                static_cast<unsigned>(total.loads),
+                static_cast<unsigned>(total.stores),
+                expected ? "" : "  MISMATCH");
+    if (!expected) {
+        std::printf("%-40s %6u %6u  expected\n", "",
+                    static_cast<unsigned>(loads), static_cast<unsigned>(stores));
+        failed = true;
+    }
+}
+
+static void Check(const char *name, bool passed) {
+    std::printf("%-40s %13s\n", name, passed ? "ok" : "FAILED");
+    if (!passed) {
+        failed = true;
+    }
+}
+
+/* Leds are PA0..PA2 and PB3, ODR after every value, other pins kept */
+static bool LedsAre(uint32_t v) {
+    return SimBus::Peek(GPIOA::ODR::Address) == (0xA5A0U | (v & 0x7U)) &&
+           SimBus::Peek(GPIOB::ODR::Address) == (0x5A52U | (v & 0x8U));
+}
+
+static bool PinGroupWrites() {
+    bool ok = true;
+    for (uint32_t v = 0U; v < 16U; ++v) {
+        SimBus::Poke(GPIOA::ODR::Address, 0xA5A0U);
+        SimBus::Poke(GPIOB::ODR::Address, 0x5A52U);
+        Leds::Write(v);
+        ok &= LedsAre(v);
+        Leds::Toggle();
+        ok &= LedsAre(~v & 0xFU);
+        Leds::Set();
+        ok &= LedsAre(0xFU);
+    }
+    return ok;
+}
+
+/* PB4..PB11, the other pins of the port are not touched */
+static bool PortBusMoves() {
+    SimBus::Poke(GPIOB::ODR::Address, 0xF33FU);
+    Data::Write(0xA5);
+    bool ok = SimBus::Peek(GPIOB::ODR::Address) == 0xFA5FU;
+
+    SimBus::Poke(GPIOB::IDR::Address, 0xF3CFU);
+    ok &= Data::Read() == 0x3CU;
+    SimBus::Poke(GPIOB::IDR::Address, 0x0960U);
+    ok &= Data::Read() == 0x96U;
+    return ok;
+}
+
+/* every combination of Keys, the other pins of the ports are high */
+static bool PinGroupReadPacks() {
+    bool ok = true;
+    for (uint32_t v = 0U; v < 32U; ++v) {
+        SimBus::Poke(GPIOA::IDR::Address, 0xFF4FU | ((v & 1U) << 4) |
+                                          (((v >> 1) & 1U) << 5) |
+                                          (((v >> 4) & 1U) << 7));
+        SimBus::Poke(GPIOC::IDR::Address, 0xFFFEU | ((v >> 2) & 1U));
+        SimBus::Poke(GPIOB::IDR::Address, 0x7FFFU | (((v >> 3) & 1U) << 15));
+        ok &= Keys::Read() == v;
+    }
+    return ok;
+}
+
+/* n ticks with the IDR at a level, the pins they report changed */
+template <typename Debouncer>
+static uint32_t Ticks(uint32_t n, uint32_t idr) {
+    SimBus::Poke(GPIOB::IDR::Address, idr);
+    uint32_t changed = 0U;
+    for (; n != 0U; --n) {
+        changed |= Debouncer::Tick();
+    }
+    return changed;
+}
+
+/* PB4..PB7, active low: a press with a bounce, then the release */
+static bool DebouncerFilters() {
+    using Contacts = PortDebouncer<Port<GPIOB>, 0x00F0>;
+    using Ok = Contacts::Input<Pin<Port<GPIOB>, 4, PinMode::Read>>;
+
+    SimBus::Poke(GPIOB::IDR::Address, 0x00F0U);
+    Contacts::Init();
+    bool ok = Ok::Get() == 1U;
+
+    /* 3 ticks low, a bounce restarts the count */
+    ok &= Ticks<Contacts>(3U, 0x00E0U) == 0U;
+    ok &= Ticks<Contacts>(1U, 0x00F0U) == 0U;
+    ok &= Ticks<Contacts>(3U, 0x00E0U) == 0U && Ok::Get() == 1U;
+    /* the 4th tick in a row changes the state */
+    ok &= Ticks<Contacts>(1U, 0x00E0U) == 0x0010U && Ok::Get() == 0U;
+    ok &= Ok::TakeFalling() && !Ok::TakeFalling() && !Ok::TakeRising();
+
+    /* the pins out of the mask are not seen */
+    ok &= Ticks<Contacts>(8U, 0x00E1U) == 0U && Contacts::State() == 0x00E0U;
+
+    ok &= Ticks<Contacts>(3U, 0x00F0U) == 0U && Ok::Get() == 0U;
+    ok &= Ticks<Contacts>(1U, 0x00F0U) == 0x0010U && Ok::Get() == 1U;
+    ok &= Ok::TakeRising() && !Ok::TakeRising() && !Ok::TakeFalling();
+    return ok;
+}
+
+int main() {
+    SimBus::Reset();
+    SimBus::AttachGpio<GPIOA>();
+    SimBus::AttachGpio<GPIOB>();
+
+    std::printf("%-40s %6s %6s\n", "call", "loads", "stores");
+
+    Report("Register::Set",               0, 1, [] { GPIOB::ODR::Set(0x01); });
+    Report("Register::Get",               1, 0, [] { GPIOB::IDR::Get(); });
+    Report("Register::Toggle",            1, 1, [] { GPIOB::ODR::Toggle(0x01); });
+    Report("RegisterField::Set",          1, 1, [] { GPIOB::CRL::CRL1::Set(0x03); });
+    Report("FieldValue::Set",             1, 1, [] { GPIOB::ODR::ODR0::High::Set(); });
+    Report("FieldValue::Set (BSRR)",      0, 1, [] { GPIOB::BSRR::BR0::Low::Set(); });
+    Report("BitBand::Set",                0, 1, [] { GPIOB::ODR::ODR0::BitBand::Set(); });
+    Report("BitBand::Get",                1, 0, [] { GPIOB::ODR::ODR0::BitBand::Get(); });
+    Report("FieldValue::IsSet",           1, 0, [] { GPIOB::ODR::ODR0::High::IsSet(); });
+    Report("FieldValue::Set (rc_w0 SR)",  0, 1, [] { USART1::SR::TC::Clear::Set(); });
+    Report("RegisterFieldSet::Set",       1, 1, [] {
+        GPIOA::CRLSet<
+            GPIOA::CRL::CRL0::OutPP50MHz,
+            GPIOA::CRL::CRL1::OutPP2MHz,
+            GPIOA::CRL::CRL7::InFloat
+        >::Set();
+    });
+    Report("Transaction::Set (3 regs)",   2, 3, [] {
+        Transaction<
+            GPIOA::CRL::CRL0::OutPP50MHz,
+            GPIOA::CRH::CRH7::InFloat,
+            GPIOA::CRL::CRL1::OutPP2MHz,
+            GPIOA::BSRR::BS0::High
+        >::Set();
+    });
+    Report("Board::Init (3 ports)",       1, 7, [] {
+        Board<
+            PinConfig<Led,                               PinSetup::OutputHigh>,
+            PinConfig<Pin<Port<GPIOA>, 1,  PinMode::Config>, PinSetup::InputPullDown>,
+            PinConfig<Pin<Port<GPIOA>, 9,  PinMode::Config>, PinSetup::InputPullUp>,
+            PinConfig<Pin<Port<GPIOB>, 3,  PinMode::Config>, PinSetup::OutputLow>,
+            PinConfig<Pin<Port<GPIOC>, 13, PinMode::Config>, PinSetup::InputFloat>
+        >::Init();
+    });
+    Report("Pin::Set",                    0, 1, [] { Led::Set(); });
+    Report("Pin::Reset",                  0, 1, [] { Led::Reset(); });
+    Report("Pin::Toggle",                 1, 1, [] { Led::Toggle(); });
+    Report("Pin::Get",                    1, 0, [] { Led::Get(); });
+    Report("Pin::ConfigOutput",           1, 1, [] { Led::ConfigOutput(); });
+    Report("Pin::ConfigInput",            1, 2, [] { Led::ConfigInput(); });
+    Report("PinGroup::Set (2 ports)",     0, 2, [] { Leds::Set(); });
+    Report("PinGroup::Write (2 ports)",   0, 2, [] { Leds::Write(0x05); });
+    Report("PinGroup::Toggle (2 ports)",  2, 2, [] { Leds::Toggle(); });
+    Report("PinGroup::Read (3 ports)",    3, 0, [] { Keys::Read(); });
+    Report("PortDebouncer::Tick (16 pins)", 1, 0, [] {
+        PortDebouncer<Port<GPIOB>>::Tick();
+    });
+    Report("PortBus::Write (8 bits)",     0, 1, [] { Data::Write(0xA5); });
+    Report("PortBus::Read (8 bits)",      1, 0, [] { Data::Read(); });
+    Report("PortBus::ConfigOutput",       2, 2, [] { Data::ConfigOutput(); });
+    Report("PortBus::ConfigInput",        2, 3, [] {
+        Data::ConfigInput<Data::InputMode::PullUp>();
+    });
+
+    std::printf("\n%-40s %13s\n", "values", "");
+    Check("PinGroup::Write, Toggle, Set",    PinGroupWrites());
+    Check("PortBus::Write, Read",            PortBusMoves());
+    Check("PinGroup::Read (32 values)",      PinGroupReadPacks());
+    Check("PortDebouncer (bounce, edges)",   DebouncerFilters());
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
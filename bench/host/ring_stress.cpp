@@ -0,0 +1,137 @@
+/* 2021 Nikolai Chizhov */
+
+/* Ring buffer stress test
+ *
+ * The producers and the consumer of code/inc/ring_buffer.hpp run in
+ *   threads, which preempt each other at any point like interrupts do.
+ *   Every item carries its producer and sequence number, the consumer checks
+ *   that nothing is lost, duplicated or reordered, and prints the throughput.
+ *   A side that cannot progress yields, so it runs on a single core too.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "ring_buffer.hpp"
+
+static constexpr uint32_t itemsPerProducer = 2'000'000U;
+static constexpr uint32_t producers = 3U;
+static constexpr size_t bulk = 16U;
+
+static uint32_t MakeItem(uint32_t producer, uint32_t seq) {
+    return (producer << 24U) | seq;
+}
+
+static void Check(bool ok, const char *what) {
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+template <typename Func>
+static void Report(const char *name, uint32_t items, Func func) {
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double> time =
+        std::chrono::steady_clock::now() - start;
+    std::printf("%-32s %8.2f Mitems/s\n", name, items / time.count() / 1e6);
+}
+
+/* single items one side, bulk spans the other */
+static void Spsc() {
+    static SpscRing<uint32_t, 1024U> ring;
+
+    std::thread producer([] {
+        uint32_t buf[bulk];
+        uint32_t seq = 0;
+        while (seq < itemsPerProducer) {
+            if (seq % 2U == 0U) {
+                if (ring.Push(MakeItem(0, seq))) {
+                    ++seq;
+                } else {
+                    std::this_thread::yield();
+                }
+            } else {
+                uint32_t n = 0;
+                for (; n < bulk && seq + n < itemsPerProducer; ++n) {
+                    buf[n] = MakeItem(0, seq + n);
+                }
+                const size_t pushed = ring.Push(buf, n);
+                if (pushed == 0U) {
+                    std::this_thread::yield();
+                }
+                seq += static_cast<uint32_t>(pushed);
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    while (expected < itemsPerProducer) {
+        const auto span = ring.ReadSpan();
+        for (size_t i = 0; i < span.size; ++i) {
+            Check(span.data[i] == MakeItem(0, expected++), "SPSC order");
+        }
+        ring.Consume(span.size);
+        if (span.size == 0U) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    Check(ring.IsEmpty(), "SPSC empty");
+}
+
+static void Mpsc() {
+    static MpscRing<uint32_t, 1024U> ring;
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([p] {
+            uint32_t buf[bulk];
+            uint32_t seq = 0;
+            while (seq < itemsPerProducer) {
+                const uint32_t n = (seq % 3U == 0U) ? 1U :
+                    std::min<uint32_t>(bulk, itemsPerProducer - seq);
+                for (uint32_t i = 0; i < n; ++i) {
+                    buf[i] = MakeItem(p, seq + i);
+                }
+                if (ring.Push(buf, n)) {
+                    seq += n;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    uint32_t next[producers] = {};
+    uint32_t total = 0;
+    uint32_t buf[64];
+    while (total < itemsPerProducer * producers) {
+        const size_t n = ring.Pop(buf, 64U);
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t p = buf[i] >> 24U;
+            Check(p < producers, "MPSC producer");
+            Check((buf[i] & 0xFFFFFFU) == next[p]++, "MPSC order");
+        }
+        total += static_cast<uint32_t>(n);
+        if (n == 0U) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    Check(ring.IsEmpty(), "MPSC empty");
+}
+
+int main() {
+    Report("SpscRing, 1 producer", itemsPerProducer, Spsc);
+    Report("MpscRing, 3 producers", itemsPerProducer * producers, Mpsc);
+    std::printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,225 @@
+/* 2021 Nikolai Chizhov */
+
+/* The whole device model
+ *
+ * Includes every header generated from the SVD (target svd_headers) along
+ *   with regs_f103.hpp, and checks the hand-written fields against the SVD:
+ *   a copy-paste offset fails the build. The compile time of this file is
+ *   the budget checked by tools/compile_budget.py (target svd_compile_budget).
+ */
+
+#include <cstdint>
+#include <cstdio>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+#include "svd/stm32f103.hpp"
+
+/* the same bits of the same address, the register sizes may differ */
+template <typename Hand, typename Gen>
+constexpr bool sameField =
+    Hand::Register::Address == Gen::Register::Address &&
+    Hand::Offset == Gen::Offset && Hand::Size == Gen::Size;
+
+template <typename Hand, typename Gen>
+constexpr bool sameRegister = Hand::Address == Gen::Address;
+
+/* RCC */
+static_assert(sameField<RCC::CR::PLLRDY,        svd::RCC::CR::PLLRDY>);
+static_assert(sameField<RCC::CR::PLLON,         svd::RCC::CR::PLLON>);
+static_assert(sameField<RCC::CR::HSEBYP,        svd::RCC::CR::HSEBYP>);
+static_assert(sameField<RCC::CR::HSERDY,        svd::RCC::CR::HSERDY>);
+static_assert(sameField<RCC::CR::HSEON,         svd::RCC::CR::HSEON>);
+static_assert(sameField<RCC::CR::HSIRDY,        svd::RCC::CR::HSIRDY>);
+static_assert(sameField<RCC::CR::HSION,         svd::RCC::CR::HSION>);
+static_assert(sameField<RCC::CFGR::PLLMUL,      svd::RCC::CFGR::PLLMUL>);
+static_assert(sameField<RCC::CFGR::PLLXTPRE,    svd::RCC::CFGR::PLLXTPRE>);
+static_assert(sameField<RCC::CFGR::PLLSRC,      svd::RCC::CFGR::PLLSRC>);
+static_assert(sameField<RCC::CFGR::ADCPRE,      svd::RCC::CFGR::ADCPRE>);
+static_assert(sameField<RCC::CFGR::PPRE2,       svd::RCC::CFGR::PPRE2>);
+static_assert(sameField<RCC::CFGR::PPRE1,       svd::RCC::CFGR::PPRE1>);
+static_assert(sameField<RCC::CFGR::HPRE,        svd::RCC::CFGR::HPRE>);
+static_assert(sameField<RCC::CFGR::SWS,         svd::RCC::CFGR::SWS>);
+static_assert(sameField<RCC::CFGR::SW,          svd::RCC::CFGR::SW>);
+static_assert(sameField<RCC::AHBENR::DMA1EN,    svd::RCC::AHBENR::DMA1EN>);
+static_assert(sameField<RCC::APB2ENR::USART1EN, svd::RCC::APB2ENR::USART1EN>);
+static_assert(sameField<RCC::APB2ENR::ADC2EN,   svd::RCC::APB2ENR::ADC2EN>);
+static_assert(sameField<RCC::APB2ENR::ADC1EN,   svd::RCC::APB2ENR::ADC1EN>);
+static_assert(sameField<RCC::APB2ENR::GPIOCEN,  svd::RCC::APB2ENR::IOPCEN>);
+static_assert(sameField<RCC::APB2ENR::GPIOBEN,  svd::RCC::APB2ENR::IOPBEN>);
+static_assert(sameField<RCC::APB2ENR::GPIOAEN,  svd::RCC::APB2ENR::IOPAEN>);
+static_assert(sameField<RCC::APB2ENR::AFIOEN,   svd::RCC::APB2ENR::AFIOEN>);
+static_assert(sameField<RCC::APB1ENR::USART3EN, svd::RCC::APB1ENR::USART3EN>);
+static_assert(sameField<RCC::APB1ENR::USART2EN, svd::RCC::APB1ENR::USART2EN>);
+static_assert(sameField<RCC::APB1ENR::TIM4EN,   svd::RCC::APB1ENR::TIM4EN>);
+static_assert(sameField<RCC::APB1ENR::TIM3EN,   svd::RCC::APB1ENR::TIM3EN>);
+static_assert(sameField<RCC::APB1ENR::TIM2EN,   svd::RCC::APB1ENR::TIM2EN>);
+
+/* FLASH */
+static_assert(sameField<FLASH::ACR::PRFTBS,     svd::FLASH::ACR::PRFTBS>);
+static_assert(sameField<FLASH::ACR::PRFTBE,     svd::FLASH::ACR::PRFTBE>);
+static_assert(sameField<FLASH::ACR::HLFCYA,     svd::FLASH::ACR::HLFCYA>);
+static_assert(sameField<FLASH::ACR::LATENCY,    svd::FLASH::ACR::LATENCY>);
+
+/* DMA1, the channel registers are CCRn, CNDTRn... in the SVD */
+static_assert(sameRegister<DMA1::ISR,               svd::DMA1::ISR>);
+static_assert(sameRegister<DMA1::IFCR,              svd::DMA1::IFCR>);
+static_assert(sameRegister<DMA1::Channel<1>::CCR,   svd::DMA1::CCR1>);
+static_assert(sameRegister<DMA1::Channel<4>::CNDTR, svd::DMA1::CNDTR4>);
+static_assert(sameRegister<DMA1::Channel<7>::CMAR,  svd::DMA1::CMAR7>);
+static_assert(sameField<DMA1::Channel<2>::CCR::MEM2MEM, svd::DMA1::CCR2::MEM2MEM>);
+static_assert(sameField<DMA1::Channel<2>::CCR::PL,      svd::DMA1::CCR2::PL>);
+static_assert(sameField<DMA1::Channel<2>::CCR::MSIZE,   svd::DMA1::CCR2::MSIZE>);
+static_assert(sameField<DMA1::Channel<2>::CCR::PSIZE,   svd::DMA1::CCR2::PSIZE>);
+static_assert(sameField<DMA1::Channel<2>::CCR::MINC,    svd::DMA1::CCR2::MINC>);
+static_assert(sameField<DMA1::Channel<2>::CCR::PINC,    svd::DMA1::CCR2::PINC>);
+static_assert(sameField<DMA1::Channel<2>::CCR::CIRC,    svd::DMA1::CCR2::CIRC>);
+static_assert(sameField<DMA1::Channel<2>::CCR::DIR,     svd::DMA1::CCR2::DIR>);
+static_assert(sameField<DMA1::Channel<2>::CCR::TEIE,    svd::DMA1::CCR2::TEIE>);
+static_assert(sameField<DMA1::Channel<2>::CCR::HTIE,    svd::DMA1::CCR2::HTIE>);
+static_assert(sameField<DMA1::Channel<2>::CCR::TCIE,    svd::DMA1::CCR2::TCIE>);
+static_assert(sameField<DMA1::Channel<2>::CCR::EN,      svd::DMA1::CCR2::EN>);
+
+/* USART */
+static_assert(sameRegister<USART2::DR,          svd::USART2::DR>);
+static_assert(sameRegister<USART3::BRR,         svd::USART3::BRR>);
+static_assert(sameField<USART1::SR::TXE,        svd::USART1::SR::TXE>);
+static_assert(sameField<USART1::SR::TC,         svd::USART1::SR::TC>);
+static_assert(sameField<USART1::SR::RXNE,       svd::USART1::SR::RXNE>);
+static_assert(sameField<USART1::SR::IDLE,       svd::USART1::SR::IDLE>);
+static_assert(sameField<USART1::SR::ORE,        svd::USART1::SR::ORE>);
+static_assert(sameField<USART1::SR::NE,         svd::USART1::SR::NE>);
+static_assert(sameField<USART1::SR::FE,         svd::USART1::SR::FE>);
+static_assert(sameField<USART1::SR::PE,         svd::USART1::SR::PE>);
+static_assert(sameField<USART1::CR1::UE,        svd::USART1::CR1::UE>);
+static_assert(sameField<USART1::CR1::M,         svd::USART1::CR1::M>);
+static_assert(sameField<USART1::CR1::PCE,       svd::USART1::CR1::PCE>);
+static_assert(sameField<USART1::CR1::PS,        svd::USART1::CR1::PS>);
+static_assert(sameField<USART1::CR1::TXEIE,     svd::USART1::CR1::TXEIE>);
+static_assert(sameField<USART1::CR1::TCIE,      svd::USART1::CR1::TCIE>);
+static_assert(sameField<USART1::CR1::RXNEIE,    svd::USART1::CR1::RXNEIE>);
+static_assert(sameField<USART1::CR1::IDLEIE,    svd::USART1::CR1::IDLEIE>);
+static_assert(sameField<USART1::CR1::TE,        svd::USART1::CR1::TE>);
+static_assert(sameField<USART1::CR1::RE,        svd::USART1::CR1::RE>);
+static_assert(sameField<USART1::CR2::STOP,      svd::USART1::CR2::STOP>);
+static_assert(sameField<USART1::CR3::DMAT,      svd::USART1::CR3::DMAT>);
+static_assert(sameField<USART1::CR3::DMAR,      svd::USART1::CR3::DMAR>);
+static_assert(sameField<USART1::CR3::EIE,       svd::USART1::CR3::EIE>);
+
+/* TIM2..TIM4, 16-bit here and 32-bit in the SVD */
+static_assert(sameRegister<TIM3::CNT,           svd::TIM3::CNT>);
+static_assert(sameRegister<TIM3::PSC,           svd::TIM3::PSC>);
+static_assert(sameRegister<TIM3::ARR,           svd::TIM3::ARR>);
+static_assert(sameRegister<TIM4::EGR,           svd::TIM4::EGR>);
+static_assert(sameRegister<TIM4::CCR1,          svd::TIM4::CCR1>);
+static_assert(sameRegister<TIM4::CCR2,          svd::TIM4::CCR2>);
+static_assert(sameRegister<TIM4::CCR3,          svd::TIM4::CCR3>);
+static_assert(sameRegister<TIM4::CCR4,          svd::TIM4::CCR4>);
+static_assert(sameField<TIM2::CR1::ARPE,        svd::TIM2::CR1::ARPE>);
+static_assert(sameField<TIM2::CR1::OPM,         svd::TIM2::CR1::OPM>);
+static_assert(sameField<TIM2::CR1::URS,         svd::TIM2::CR1::URS>);
+static_assert(sameField<TIM2::CR1::UDIS,        svd::TIM2::CR1::UDIS>);
+static_assert(sameField<TIM2::CR1::CEN,         svd::TIM2::CR1::CEN>);
+static_assert(sameField<TIM2::DIER::UDE,        svd::TIM2::DIER::UDE>);
+static_assert(sameField<TIM2::DIER::UIE,        svd::TIM2::DIER::UIE>);
+static_assert(sameField<TIM2::SR::UIF,          svd::TIM2::SR::UIF>);
+static_assert(sameField<TIM2::CCMR1::OC2M,      svd::TIM2::CCMR1_Output::OC2M>);
+static_assert(sameField<TIM2::CCMR1::OC2PE,     svd::TIM2::CCMR1_Output::OC2PE>);
+static_assert(sameField<TIM2::CCMR1::OC2FE,     svd::TIM2::CCMR1_Output::OC2FE>);
+static_assert(sameField<TIM2::CCMR1::CC2S,      svd::TIM2::CCMR1_Output::CC2S>);
+static_assert(sameField<TIM2::CCMR1::OC1M,      svd::TIM2::CCMR1_Output::OC1M>);
+static_assert(sameField<TIM2::CCMR1::OC1PE,     svd::TIM2::CCMR1_Output::OC1PE>);
+static_assert(sameField<TIM2::CCMR1::OC1FE,     svd::TIM2::CCMR1_Output::OC1FE>);
+static_assert(sameField<TIM2::CCMR1::CC1S,      svd::TIM2::CCMR1_Output::CC1S>);
+static_assert(sameField<TIM2::CCMR2::OC4M,      svd::TIM2::CCMR2_Output::OC4M>);
+static_assert(sameField<TIM2::CCMR2::OC4PE,     svd::TIM2::CCMR2_Output::OC4PE>);
+static_assert(sameField<TIM2::CCMR2::OC4FE,     svd::TIM2::CCMR2_Output::OC4FE>);
+static_assert(sameField<TIM2::CCMR2::CC4S,      svd::TIM2::CCMR2_Output::CC4S>);
+static_assert(sameField<TIM2::CCMR2::OC3M,      svd::TIM2::CCMR2_Output::OC3M>);
+static_assert(sameField<TIM2::CCMR2::OC3PE,     svd::TIM2::CCMR2_Output::OC3PE>);
+static_assert(sameField<TIM2::CCMR2::OC3FE,     svd::TIM2::CCMR2_Output::OC3FE>);
+static_assert(sameField<TIM2::CCMR2::CC3S,      svd::TIM2::CCMR2_Output::CC3S>);
+static_assert(sameField<TIM2::CCER::CC4P,       svd::TIM2::CCER::CC4P>);
+static_assert(sameField<TIM2::CCER::CC4E,       svd::TIM2::CCER::CC4E>);
+static_assert(sameField<TIM2::CCER::CC3P,       svd::TIM2::CCER::CC3P>);
+static_assert(sameField<TIM2::CCER::CC3E,       svd::TIM2::CCER::CC3E>);
+static_assert(sameField<TIM2::CCER::CC2P,       svd::TIM2::CCER::CC2P>);
+static_assert(sameField<TIM2::CCER::CC2E,       svd::TIM2::CCER::CC2E>);
+static_assert(sameField<TIM2::CCER::CC1P,       svd::TIM2::CCER::CC1P>);
+static_assert(sameField<TIM2::CCER::CC1E,       svd::TIM2::CCER::CC1E>);
+
+/* ADC */
+static_assert(sameRegister<ADC2::DR,            svd::ADC2::DR>);
+static_assert(sameField<ADC1::SR::STRT,         svd::ADC1::SR::STRT>);
+static_assert(sameField<ADC1::SR::JSTRT,        svd::ADC1::SR::JSTRT>);
+static_assert(sameField<ADC1::SR::JEOC,         svd::ADC1::SR::JEOC>);
+static_assert(sameField<ADC1::SR::EOC,          svd::ADC1::SR::EOC>);
+static_assert(sameField<ADC1::SR::AWD,          svd::ADC1::SR::AWD>);
+static_assert(sameField<ADC1::CR1::AWDEN,       svd::ADC1::CR1::AWDEN>);
+static_assert(sameField<ADC1::CR1::JAWDEN,      svd::ADC1::CR1::JAWDEN>);
+static_assert(sameField<ADC1::CR1::DUALMOD,     svd::ADC1::CR1::DUALMOD>);
+static_assert(sameField<ADC1::CR1::DISCNUM,     svd::ADC1::CR1::DISCNUM>);
+static_assert(sameField<ADC1::CR1::JDISCEN,     svd::ADC1::CR1::JDISCEN>);
+static_assert(sameField<ADC1::CR1::DISCEN,      svd::ADC1::CR1::DISCEN>);
+static_assert(sameField<ADC1::CR1::JAUTO,       svd::ADC1::CR1::JAUTO>);
+static_assert(sameField<ADC1::CR1::AWDSGL,      svd::ADC1::CR1::AWDSGL>);
+static_assert(sameField<ADC1::CR1::SCAN,        svd::ADC1::CR1::SCAN>);
+static_assert(sameField<ADC1::CR1::JEOCIE,      svd::ADC1::CR1::JEOCIE>);
+static_assert(sameField<ADC1::CR1::AWDIE,       svd::ADC1::CR1::AWDIE>);
+static_assert(sameField<ADC1::CR1::EOCIE,       svd::ADC1::CR1::EOCIE>);
+static_assert(sameField<ADC1::CR1::AWDCH,       svd::ADC1::CR1::AWDCH>);
+static_assert(sameField<ADC1::CR2::TSVREFE,     svd::ADC1::CR2::TSVREFE>);
+static_assert(sameField<ADC1::CR2::SWSTART,     svd::ADC1::CR2::SWSTART>);
+static_assert(sameField<ADC1::CR2::JSWSTART,    svd::ADC1::CR2::JSWSTART>);
+static_assert(sameField<ADC1::CR2::EXTTRIG,     svd::ADC1::CR2::EXTTRIG>);
+static_assert(sameField<ADC1::CR2::EXTSEL,      svd::ADC1::CR2::EXTSEL>);
+static_assert(sameField<ADC1::CR2::JEXTTRIG,    svd::ADC1::CR2::JEXTTRIG>);
+static_assert(sameField<ADC1::CR2::JEXTSEL,     svd::ADC1::CR2::JEXTSEL>);
+static_assert(sameField<ADC1::CR2::ALIGN,       svd::ADC1::CR2::ALIGN>);
+static_assert(sameField<ADC1::CR2::DMA,         svd::ADC1::CR2::DMA>);
+static_assert(sameField<ADC1::CR2::RSTCAL,      svd::ADC1::CR2::RSTCAL>);
+static_assert(sameField<ADC1::CR2::CAL,         svd::ADC1::CR2::CAL>);
+static_assert(sameField<ADC1::CR2::CONT,        svd::ADC1::CR2::CONT>);
+static_assert(sameField<ADC1::CR2::ADON,        svd::ADC1::CR2::ADON>);
+static_assert(sameField<ADC1::SMPR1::SMP17,     svd::ADC1::SMPR1::SMP17>);
+static_assert(sameField<ADC1::SMPR1::SMP10,     svd::ADC1::SMPR1::SMP10>);
+static_assert(sameField<ADC1::SMPR2::SMP9,      svd::ADC1::SMPR2::SMP9>);
+static_assert(sameField<ADC1::SMPR2::SMP0,      svd::ADC1::SMPR2::SMP0>);
+static_assert(sameField<ADC1::SQR1::L,          svd::ADC1::SQR1::L>);
+static_assert(sameField<ADC1::SQR1::SQ16,       svd::ADC1::SQR1::SQ16>);
+static_assert(sameField<ADC1::SQR1::SQ13,       svd::ADC1::SQR1::SQ13>);
+static_assert(sameField<ADC1::SQR2::SQ12,       svd::ADC1::SQR2::SQ12>);
+static_assert(sameField<ADC1::SQR2::SQ7,        svd::ADC1::SQR2::SQ7>);
+static_assert(sameField<ADC1::SQR3::SQ6,        svd::ADC1::SQR3::SQ6>);
+static_assert(sameField<ADC1::SQR3::SQ1,        svd::ADC1::SQR3::SQ1>);
+
+/* AFIO, EXTI */
+static_assert(sameRegister<AFIO::EXTICR<0>,     svd::AFIO::EXTICR1>);
+static_assert(sameRegister<AFIO::EXTICR<3>,     svd::AFIO::EXTICR4>);
+static_assert(sameField<EXTI::IMR::MR<0>,       svd::EXTI::IMR::MR0>);
+static_assert(sameField<EXTI::IMR::MR<15>,      svd::EXTI::IMR::MR15>);
+static_assert(sameField<EXTI::RTSR::TR<7>,      svd::EXTI::RTSR::TR7>);
+static_assert(sameField<EXTI::FTSR::TR<7>,      svd::EXTI::FTSR::TR7>);
+static_assert(sameRegister<EXTI::SWIER,         svd::EXTI::SWIER>);
+static_assert(sameRegister<EXTI::PR,            svd::EXTI::PR>);
+
+/* GPIO, CRL/CRH nibbles are MODEn and CNFn in the SVD */
+static_assert(sameRegister<GPIOA::CRL,          svd::GPIOA::CRL>);
+static_assert(sameRegister<GPIOB::CRH,          svd::GPIOB::CRH>);
+static_assert(sameField<GPIOC::IDR::IDR15,      svd::GPIOC::IDR::IDR15>);
+static_assert(sameField<GPIOC::IDR::IDR1,       svd::GPIOC::IDR::IDR1>);
+static_assert(sameField<GPIOC::IDR::IDR0,       svd::GPIOC::IDR::IDR0>);
+static_assert(sameField<GPIOD::ODR::ODR15,      svd::GPIOD::ODR::ODR15>);
+static_assert(sameField<GPIOD::ODR::ODR1,       svd::GPIOD::ODR::ODR1>);
+static_assert(sameField<GPIOD::ODR::ODR0,       svd::GPIOD::ODR::ODR0>);
+static_assert(sameField<GPIOA::BSRR::BR15,      svd::GPIOA::BSRR::BR15>);
+static_assert(sameField<GPIOA::BSRR::BR1,       svd::GPIOA::BSRR::BR1>);
+static_assert(sameField<GPIOA::BSRR::BR0,       svd::GPIOA::BSRR::BR0>);
+static_assert(sameField<GPIOA::BSRR::BS15,      svd::GPIOA::BSRR::BS15>);
+static_assert(sameField<GPIOA::BSRR::BS1,       svd::GPIOA::BSRR::BS1>);
+static_assert(sameField<GPIOA::BSRR::BS0,       svd::GPIOA::BSRR::BS0>);
+
+int main() {
+    std::printf("regs_f103.hpp matches the SVD model\n");
+    return 0;
+}
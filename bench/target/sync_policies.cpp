@@ -0,0 +1,85 @@
+/* 2021 Nikolai Chizhov */
+
+/* Concurrency policy benchmark (on target)
+ *
+ * Measures the cycles of a read-modify-write of a GPIO register with every
+ *   Utils::Sync policy using the DWT cycle counter. The result is printed via
+ *   semihosting (rdimon, set up first in main), so run it under a debugger.
+ *
+ * The boot time of the build (reset to main, startup.hpp) and the part of
+ *   it that inits .data go first.
+ */
+
+#include <cstdint>
+#include <cstdio>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+#include "cycle_counter.hpp"
+#include "sync.hpp"
+#include "startup.hpp"
+#include "vectors.hpp"
+
+/* rdimon: opens stdout on the debugger, Reset_Handler does not call it */
+extern "C" void initialise_monitor_handles();
+
+extern "C" __attribute__((section(".isr_vector"), used))
+const VectorTable<>::Type vectorTable = VectorTable<>::Make();
+
+static constexpr uint32_t runs = 16U;
+
+/* CYCCNT read-to-read overhead */
+static uint32_t overhead = 0U;
+
+template <typename Policy, typename Reg>
+static uint32_t Measure(typename Reg::Type mask, typename Reg::Type value) {
+    uint32_t best = UINT32_MAX;
+    for (uint32_t i = 0; i < runs; ++i) {
+        const uint32_t start = CycleCounter::Now();
+        Policy::template Modify<typename Reg::Type, typename Reg::Bus>(
+            Reg::Address, mask, value);
+        const uint32_t cycles = CycleCounter::Since(start);
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    return best - overhead;
+}
+
+template <typename Policy>
+static void Report(const char *name) {
+    /* a 1-bit field (ODR0) and a 4-bit field (CRL1) */
+    const uint32_t bit = Measure<Policy, GPIOA::ODR>(0x0001U, 0x0001U);
+    const uint32_t nibble = Measure<Policy, GPIOA::CRL>(0x00F0U, 0x0030U);
+    std::printf("%-16s %6lu %6lu\n", name,
+                static_cast<unsigned long>(bit),
+                static_cast<unsigned long>(nibble));
+}
+
+int main() {
+    initialise_monitor_handles();
+
+    RCC::APB2ENR::GPIOAEN::BitBand::Set();
+    CycleCounter::Enable();
+
+    overhead = UINT32_MAX;
+    for (uint32_t i = 0; i < runs; ++i) {
+        const uint32_t start = CycleCounter::Now();
+        const uint32_t cycles = CycleCounter::Since(start);
+        if (cycles < overhead) {
+            overhead = cycles;
+        }
+    }
+
+    std::printf("boot %lu cycles, .data %lu cycles\n",
+                static_cast<unsigned long>(Startup::BootCycles()),
+                static_cast<unsigned long>(Startup::DataCycles()));
+
+    std::printf("%-16s %6s %6s\n", "policy", "1 bit", "4 bits");
+    Report<Utils::Sync::None>("None");
+    Report<Utils::Sync::Exclusive>("Exclusive");
+    Report<Utils::Sync::CriticalSection>("CriticalSection");
+    Report<Utils::Sync::BitBand>("BitBand");
+
+    while (1);
+}
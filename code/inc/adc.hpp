@@ -0,0 +1,215 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+#include "dma.hpp"
+#include "nvic.hpp"
+
+/* Sample time in ADC clock cycles */
+enum class AdcSampleTime : uint32_t {
+    Cycles1_5   = 0b000,
+    Cycles7_5   = 0b001,
+    Cycles13_5  = 0b010,
+    Cycles28_5  = 0b011,
+    Cycles41_5  = 0b100,
+    Cycles55_5  = 0b101,
+    Cycles71_5  = 0b110,
+    Cycles239_5 = 0b111
+};
+
+/* One conversion of the scan
+ *
+ * ch           - 0..7 PA0..PA7, 8..9 PB0..PB1, 10..15 PC0..PC5,
+ *                16 temperature sensor, 17 VREFINT
+ * sampleTime   - longer for a source with a higher impedance,
+ *                17.1 us at least for the temperature sensor
+ */
+template <uint32_t ch, AdcSampleTime sampleTime = AdcSampleTime::Cycles55_5>
+struct AdcInput {
+    static_assert(ch <= 17U, "ADC channels are 0..17");
+
+private:
+    static constexpr uint32_t sampleHalfCycles[] = {
+        3U, 15U, 27U, 57U, 83U, 111U, 143U, 479U
+    };
+
+public:
+    static constexpr uint32_t Channel = ch;
+    static constexpr uint32_t SampleTime = static_cast<uint32_t>(sampleTime);
+
+    /* sampling + 12.5 cycles of conversion, in half cycles of ADCCLK */
+    static constexpr uint32_t HalfCycles = sampleHalfCycles[SampleTime] + 25U;
+};
+
+/* template for AdcSequence class
+ *
+ * The regular scan, the SMPR and SQR words are computed at compile time.
+ *
+ * Inputs - AdcInputs in the order of conversion, up to 16, a channel may
+ *          repeat with the same sample time
+ */
+template <typename... Inputs>
+struct AdcSequence {
+    static constexpr size_t Size = sizeof...(Inputs);
+
+    static_assert(Size >= 1U && Size <= 16U, "The scan is 1..16 conversions");
+
+    /* the sample time of a channel is one for the whole scan */
+    template <typename T>
+    static constexpr bool sameSampleTime =
+        ((T::Channel != Inputs::Channel || T::SampleTime == Inputs::SampleTime) && ...);
+    static_assert((sameSampleTime<Inputs> && ...),
+                  "A channel has different sample times");
+
+    /* channels 10..17 in SMPR1, 0..9 in SMPR2, 3 bits each */
+    static constexpr uint32_t Smpr1 =
+        ((Inputs::Channel >= 10U ?
+          Inputs::SampleTime << ((Inputs::Channel - 10U) * 3U) : 0U) | ...);
+    static constexpr uint32_t Smpr2 =
+        ((Inputs::Channel < 10U ?
+          Inputs::SampleTime << (Inputs::Channel * 3U) : 0U) | ...);
+
+    /* ranks 1..6 in SQR3, 7..12 in SQR2, 13..16 and the length in SQR1 */
+    static constexpr uint32_t Sqr(size_t first) {
+        const uint32_t channels[] = {Inputs::Channel...};
+        uint32_t word = 0U;
+        for (size_t rank = first; rank < Size && rank < first + 6U; ++rank) {
+            word |= channels[rank] << ((rank - first) * 5U);
+        }
+        return word;
+    }
+    static constexpr uint32_t Sqr1 = Sqr(12U) | ((Size - 1U) << 20U);
+    static constexpr uint32_t Sqr2 = Sqr(6U);
+    static constexpr uint32_t Sqr3 = Sqr(0U);
+
+    /* the temperature sensor or VREFINT is in use */
+    static constexpr bool HasInternal = ((Inputs::Channel >= 16U) || ...);
+
+    /* the whole scan, in half cycles of ADCCLK */
+    static constexpr uint32_t HalfCycles = (Inputs::HalfCycles + ...);
+};
+
+/* the samples of a half of the buffer: `sequences` scans, one after another */
+using AdcCallback = void (*)(const uint16_t *samples, size_t sequences);
+
+/* template for AdcScan class
+ *
+ * ADC1 converts the sequence continuously, and DMA1 channel 1 stores the
+ *   results into a circular buffer of two halves. The DMA interrupt calls
+ *   onHalf when the first half is complete and onFull for the second one,
+ *   so a half is processed in place while the other is filled. There are
+ *   no interrupts per sample.
+ *
+ * A callback runs in the DMA interrupt and must be done with its half
+ *   before the hardware wraps around to it: depth * SequenceHz gives the
+ *   time. The analog pins are configured by Board (PinSetup::InputAnalog).
+ *   ADC2 has no DMA request, so it is not supported here.
+ *
+ * Clock    - ClockConfig from clock.hpp, ADCCLK is PCLK2 / ADCPRE
+ * Sequence - AdcSequence
+ * depth    - scans per half of the buffer
+ * onHalf, onFull - callbacks
+ *
+ * Example:
+ *   using Sensors = AdcSequence<AdcInput<1>, AdcInput<2>,
+ *                               AdcInput<16, AdcSampleTime::Cycles239_5>>;
+ *   using Sampler = AdcScan<SystemClock, Sensors, 32, Process, Process>;
+ *   IrqHandler<Sampler::Irq, Sampler::OnDmaIrq>
+ *
+ *   Sampler::Init();
+ *   Sampler::Start();
+ */
+template <typename Clock, typename Sequence, size_t depth,
+          AdcCallback onHalf, AdcCallback onFull>
+class AdcScan {
+    using Regs = ADC1;
+    using Dma = DmaChannel<1U>;
+
+public:
+    static constexpr size_t Channels = Sequence::Size;
+    static constexpr size_t Depth = depth;
+    static constexpr size_t Samples = 2U * depth * Channels;
+    /* scans per second */
+    static constexpr uint32_t SequenceHz = Clock::AdcClk * 2U / Sequence::HalfCycles;
+
+    static constexpr IrqN Irq = Dma::Irq;
+
+    static_assert(depth > 0U && Samples <= 0xFFFFU,
+                  "The buffer is up to 65535 samples");
+    static_assert(Clock::AdcClk <= 14'000'000U, "ADCCLK must be up to 14 MHz");
+
+    /* power up, calibrate, configure; the conversions start with Start() */
+    static void Init() {
+        RCC::AHBENR::DMA1EN::BitBand::Set();
+        RCC::APB2ENR::ADC1EN::BitBand::Set();
+
+        Regs::CR2::Set(Regs::CR2::ADON::Mask);
+        /* tSTAB is 1 us, a loop takes more than a core cycle */
+        for (volatile uint32_t i = 0; i < Clock::SysClk / 1'000'000U; ++i) {
+        }
+
+        Regs::CR2::RSTCAL::BitBand::Set();
+        while (Regs::CR2::RSTCAL::BitBand::Get());
+        Regs::CR2::CAL::BitBand::Set();
+        while (Regs::CR2::CAL::BitBand::Get());
+
+        Regs::SMPR1::Set(Sequence::Smpr1);
+        Regs::SMPR2::Set(Sequence::Smpr2);
+        Regs::SQR1::Set(Sequence::Sqr1);
+        Regs::SQR2::Set(Sequence::Sqr2);
+        Regs::SQR3::Set(Sequence::Sqr3);
+        Regs::CR1::Set(Regs::CR1::SCAN::Mask);
+
+        Dma::template Configure<
+            typename Dma::CCR::DIR::FromPeripheral,
+            typename Dma::CCR::MINC::Enable,
+            typename Dma::CCR::CIRC::Enable,
+            typename Dma::CCR::MSIZE::Bits16,
+            typename Dma::CCR::PSIZE::Bits16,
+            typename Dma::CCR::PL::High,
+            typename Dma::CCR::HTIE::Enable,
+            typename Dma::CCR::TCIE::Enable
+        >(Regs::DR::Address);
+        Dma::Start(buffer, static_cast<uint32_t>(Samples));
+
+        /* other bits change along with ADON, so no conversion starts */
+        Regs::CR2::Set(cr2);
+
+        Nvic<Irq>::Enable();
+    }
+
+    static inline void Start() {
+        Regs::CR2::SWSTART::BitBand::Set();
+    }
+
+    /* the scan in progress completes */
+    static inline void Stop() {
+        Regs::CR2::CONT::BitBand::Reset();
+    }
+
+    static void OnDmaIrq() {
+        const uint32_t flags = Dma::GetFlags();
+        Dma::ClearFlags(flags);
+
+        if (flags & Dma::Flags::HTIF) {
+            onHalf(&buffer[0], depth);
+        }
+        if (flags & Dma::Flags::TCIF) {
+            onFull(&buffer[depth * Channels], depth);
+        }
+    }
+
+private:
+    static constexpr uint32_t cr2 =
+        Regs::CR2::ADON::Mask | Regs::CR2::CONT::Mask | Regs::CR2::DMA::Mask |
+        Regs::CR2::EXTTRIG::Mask |
+        (Regs::CR2::EXTSEL::SwStart::Value << Regs::CR2::EXTSEL::Offset) |
+        (Sequence::HasInternal ? Regs::CR2::TSVREFE::Mask : 0U);
+
+    static inline uint16_t buffer[Samples];
+};
@@ -0,0 +1,200 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+#include "pin.hpp"
+
+/* Pin modes for Board
+ *
+ * Cr  - the 4-bit CNF + MODE value of the pin in CRL/CRH
+ * Odr - the ODR bit: the initial level of an output, pull-up (1) or
+ *       pull-down (0) of an input; -1 if it doesn't matter
+ */
+struct PinSetup {
+    template <typename CrValue, int odr>
+    struct Mode {
+        static constexpr uint32_t Cr = CrValue::Value;
+        static constexpr int Odr = odr;
+    };
+
+private:
+    using Cr = GPIOA::CRL::FieldValues;
+
+public:
+    /* as Output, push-pull */
+    using OutputLow         = Mode<Cr::OutPP50MHz, 0>;
+    using OutputHigh        = Mode<Cr::OutPP50MHz, 1>;
+    using OutputLow2MHz     = Mode<Cr::OutPP2MHz, 0>;
+    using OutputHigh2MHz    = Mode<Cr::OutPP2MHz, 1>;
+    using OutputLow10MHz    = Mode<Cr::OutPP10MHz, 0>;
+    using OutputHigh10MHz   = Mode<Cr::OutPP10MHz, 1>;
+    /* as Output of a peripheral */
+    using Alternate         = Mode<Cr::AltPP50MHz, -1>;
+    using AlternateOD       = Mode<Cr::AltOD50MHz, -1>;
+    /* as Input */
+    using InputFloat        = Mode<Cr::InFloat, -1>;
+    using InputAnalog       = Mode<Cr::InAnalog, -1>;
+    using InputPullUp       = Mode<Cr::InPushPull, 1>;
+    using InputPullDown     = Mode<Cr::InPushPull, 0>;
+};
+
+/* Configuration of one pin
+ *
+ * PinT - Pin from pin.hpp, must be configurable
+ * M    - PinSetup mode
+ */
+template <typename PinT, typename M>
+struct PinConfig {
+    using PinType = PinT;
+    using Mode = M;
+};
+
+/* template for Board class
+ *
+ * The whole GPIO configuration of the board. The final CRL, CRH and ODR words
+ *   of every used port and the RCC clock enable mask are computed at compile
+ *   time, so Init() is a handful of stores:
+ *    - one RMW of RCC::APB2ENR to enable the clocks of all the used ports,
+ *    - per port: a store to ODR (levels, pull-ups) and a store to CRL and/or
+ *      CRH. Unlisted pins of a used port get the reset value (floating input).
+ *
+ * Configs - PinConfigs
+ *
+ * Example:
+ *   using MyBoard = Board<
+ *       PinConfig<Led,       PinSetup::OutputHigh>,
+ *       PinConfig<ButtonCfg, PinSetup::InputPullDown>
+ *   >;
+ *   MyBoard::Init();
+ */
+template <typename... Configs>
+class Board {
+public:
+    /* RCC::APB2ENR bits of the used ports */
+    static constexpr uint32_t ClockMask =
+        ((1U << Configs::PinType::PortType::Regs::ClockEnableOffset) | ...);
+
+    template <typename P>
+    static constexpr uint32_t Crl() {
+        return CrWord<P>(0U);
+    }
+
+    template <typename P>
+    static constexpr uint32_t Crh() {
+        return CrWord<P>(pinsPerCr);
+    }
+
+    template <typename P>
+    static constexpr uint32_t Odr() {
+        return ((IsPinOf<P, Configs>() && Configs::Mode::Odr == 1 ?
+                 (1U << Configs::PinType::Number) : 0U) | ...);
+    }
+
+    static void Init() {
+        RCC::APB2ENR::SetMasked(ClockMask, ClockMask);
+
+        ForEachPort(std::index_sequence_for<Configs...>{});
+    }
+
+private:
+    static constexpr size_t configsNum = sizeof...(Configs);
+    static_assert(configsNum > 0U, "Board cannot be empty");
+
+    static constexpr uint32_t pinsPerCr = 8U;
+    static constexpr uint32_t crResetValue = 0x44444444U;
+
+    static_assert((std::is_base_of_v<PinMode::Config,
+                                     typename Configs::PinType::Access> && ...),
+                  "All the pins must be configurable");
+
+    template <typename T>
+    static constexpr size_t countOf =
+        ((std::is_same_v<typename T::PinType::PortType,
+                         typename Configs::PinType::PortType> &&
+          T::PinType::Number == Configs::PinType::Number) + ...);
+    static_assert(((countOf<Configs> == 1U) && ...),
+                  "A pin is configured twice");
+
+    template <size_t i>
+    using ConfigAt = std::tuple_element_t<i, std::tuple<Configs...>>;
+
+    template <typename P, typename C>
+    static constexpr bool IsPinOf() {
+        return std::is_same_v<P, typename C::PinType::PortType>;
+    }
+
+    /* the pins of the port in the CR register starting from the first pin */
+    template <typename P>
+    static constexpr uint32_t CrMask(uint32_t first) {
+        return ((IsPinOf<P, Configs>() &&
+                 Configs::PinType::Number >= first &&
+                 Configs::PinType::Number < first + pinsPerCr ?
+                 (0xFU << ((Configs::PinType::Number - first) * 4U)) : 0U) | ...);
+    }
+
+    template <typename P>
+    static constexpr uint32_t CrWord(uint32_t first) {
+        const uint32_t value =
+            ((IsPinOf<P, Configs>() &&
+              Configs::PinType::Number >= first &&
+              Configs::PinType::Number < first + pinsPerCr ?
+              (Configs::Mode::Cr << ((Configs::PinType::Number - first) * 4U)) :
+              0U) | ...);
+        return (crResetValue & ~CrMask<P>(first)) | value;
+    }
+
+    /* the pin is the first one of its port in the list */
+    template <size_t i>
+    static constexpr bool IsFirstOfPort() {
+        constexpr bool samePort[] = {
+            IsPinOf<typename ConfigAt<i>::PinType::PortType, Configs>()...
+        };
+        for (size_t j = 0; j < i; ++j) {
+            if (samePort[j]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename P>
+    static constexpr bool HasOdr() {
+        return ((IsPinOf<P, Configs>() && Configs::Mode::Odr >= 0) || ...);
+    }
+
+    template <typename P>
+    static inline void InitPort() {
+        using Regs = typename P::Regs;
+
+        /* levels first, so outputs don't glitch when they are enabled */
+        if constexpr (HasOdr<P>()) {
+            Regs::ODR::Set(Odr<P>());
+        }
+        if constexpr (CrMask<P>(0U) != 0U) {
+            Regs::CRL::Set(Crl<P>());
+        }
+        if constexpr (CrMask<P>(pinsPerCr) != 0U) {
+            Regs::CRH::Set(Crh<P>());
+        }
+    }
+
+    template <size_t i>
+    static inline void VisitPort() {
+        if constexpr (IsFirstOfPort<i>()) {
+            InitPort<typename ConfigAt<i>::PinType::PortType>();
+        }
+    }
+
+    template <size_t... I>
+    static inline void ForEachPort(std::index_sequence<I...>) {
+        (VisitPort<I>(), ...);
+    }
+};
@@ -0,0 +1,76 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "utils.hpp"
+
+/* Bus policies
+ *
+ * Every register access goes through a bus policy: a static class with
+ *   Load and Store methods. The policy is a template parameter of Register,
+ *   so it is resolved at compile time and costs nothing.
+ *
+ * MmioBus  - the real hardware, a volatile access to the address
+ * SimBus   - host-side simulated register file, see bus_sim.hpp
+ *
+ * DefaultBus is MmioBus unless HWREG_BUS_SIM is defined.
+ */
+
+struct MmioBus {
+    template <typename T>
+    static inline T Load(uintptr_t address) {
+        return *reinterpret_cast<volatile T *>(address);
+    }
+
+    template <typename T>
+    static inline void Store(uintptr_t address, T value) {
+        *reinterpret_cast<volatile T *>(address) = value;
+    }
+
+    /* exclusive access, used by Utils::Sync::Atomic */
+    static inline uint32_t LoadExclusive(uintptr_t address) {
+        return Utils::Sync::__ldrex(reinterpret_cast<volatile uint32_t *>(address));
+    }
+
+    static inline uint32_t StoreExclusive(uintptr_t address, uint32_t value) {
+        return Utils::Sync::__strex(value,
+                                    reinterpret_cast<volatile uint32_t *>(address));
+    }
+
+    static inline void ClearExclusive() {
+        Utils::Sync::__clrex();
+    }
+};
+
+/* Cortex-M3 bit-band
+ *
+ * Every bit of the first 1 MB of SRAM (0x20000000) and of the peripherals
+ *   (0x40000000) is mapped to its own word in the alias region. A store to the
+ *   alias word changes the bit atomically, a load returns the bit.
+ */
+struct BitBandAlias {
+    static constexpr uintptr_t regionSize = 0x00100000U;
+    static constexpr uintptr_t aliasOffset = 0x02000000U;
+    static constexpr uintptr_t sramBase = 0x20000000U;
+    static constexpr uintptr_t periphBase = 0x40000000U;
+
+    static constexpr bool IsInRegion(uintptr_t address) {
+        return (address >= sramBase && address < sramBase + regionSize) ||
+               (address >= periphBase && address < periphBase + regionSize);
+    }
+
+    static constexpr uintptr_t Address(uintptr_t address, size_t bit) {
+        const uintptr_t base = address & 0xF0000000U;
+        return base + aliasOffset + (address - base) * 32U + bit * 4U;
+    }
+};
+
+#ifdef HWREG_BUS_SIM
+#include "bus_sim.hpp"
+using DefaultBus = SimBus;
+#else
+using DefaultBus = MmioBus;
+#endif
@@ -0,0 +1,162 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+/* Simulated register bus (host only)
+ *
+ * A register file keyed by address. Every Load and Store is counted per
+ *   register, so the number of bus accesses of any API call can be measured
+ *   without a board.
+ *
+ * Side effects of the hardware are modelled with store hooks. A hook gets the
+ *   written value and returns the value kept in the register. It may update
+ *   other registers with Poke (which is not counted as a bus access).
+ *
+ * Example:
+ *   SimBus::Reset();
+ *   SimBus::AttachGpio<GPIOA>();
+ *   Pin<Port<GPIOA>, 0, PinMode::Write>::Set();
+ *   SimBus::GetCounters(GPIOA::BSRR::Address).stores;   // 1
+ *   SimBus::Peek(GPIOA::ODR::Address);                  // 0x01
+ */
+class SimBus {
+public:
+    struct Counters {
+        uint32_t loads  = 0;
+        uint32_t stores = 0;
+    };
+
+    using StoreHook = std::function<uint32_t(uint32_t value)>;
+
+    template <typename T>
+    static T Load(uintptr_t address) {
+        if (IsBitBandAlias(address)) {
+            Cell &cell = GetCell(BitBandTarget(address));
+            ++cell.counters.loads;
+            return static_cast<T>((cell.value >> BitBandBit(address)) & 1U);
+        }
+
+        Cell &cell = GetCell(address);
+        ++cell.counters.loads;
+        return static_cast<T>(cell.value);
+    }
+
+    template <typename T>
+    static void Store(uintptr_t address, T value) {
+        if (IsBitBandAlias(address)) {
+            /* the hardware does the read-modify-write of the target word */
+            Cell &cell = GetCell(BitBandTarget(address));
+            const uint32_t bit = 1U << BitBandBit(address);
+            const uint32_t word = (value & 1U) ?
+                                  (cell.value | bit) : (cell.value & ~bit);
+            ++cell.counters.stores;
+            cell.value = cell.hook ? cell.hook(word) : word;
+            return;
+        }
+
+        Cell &cell = GetCell(address);
+        ++cell.counters.stores;
+        cell.value = cell.hook ? cell.hook(value) : value;
+    }
+
+    /* exclusive access never fails on the host */
+    static uint32_t LoadExclusive(uintptr_t address) {
+        return Load<uint32_t>(address);
+    }
+
+    static uint32_t StoreExclusive(uintptr_t address, uint32_t value) {
+        Store<uint32_t>(address, value);
+        return 0U;
+    }
+
+    static void ClearExclusive()
+    {}
+
+    /* Direct access to the register file, not counted */
+    static void Poke(uintptr_t address, uint32_t value) {
+        GetCell(address).value = value;
+    }
+
+    static uint32_t Peek(uintptr_t address) {
+        return GetCell(address).value;
+    }
+
+    static void OnStore(uintptr_t address, StoreHook hook) {
+        GetCell(address).hook = std::move(hook);
+    }
+
+    static Counters GetCounters(uintptr_t address) {
+        return GetCell(address).counters;
+    }
+
+    static Counters GetTotal() {
+        Counters total;
+        for (const auto &item : File()) {
+            total.loads  += item.second.counters.loads;
+            total.stores += item.second.counters.stores;
+        }
+        return total;
+    }
+
+    static void ResetCounters() {
+        for (auto &item : File()) {
+            item.second.counters = Counters{};
+        }
+    }
+
+    /* forget all the values, counters and hooks */
+    static void Reset() {
+        File().clear();
+    }
+
+    /* GPIO side effects: BSRR sets/resets ODR bits and always reads as 0 */
+    template <typename Gpio>
+    static void AttachGpio() {
+        OnStore(Gpio::BSRR::Address, [](uint32_t value) {
+            uint32_t odr = Peek(Gpio::ODR::Address);
+            odr &= ~(value >> 16U);
+            odr |= value & 0xFFFFU;
+            Poke(Gpio::ODR::Address, odr);
+            return 0U;
+        });
+    }
+
+private:
+    struct Cell {
+        uint32_t value = 0;
+        Counters counters;
+        StoreHook hook;
+    };
+
+    /* Cortex-M3 bit-band alias regions, see BitBandAlias in register.hpp */
+    static bool IsBitBandAlias(uintptr_t address) {
+        return (address >= 0x22000000U && address < 0x24000000U) ||
+               (address >= 0x42000000U && address < 0x44000000U);
+    }
+
+    static uintptr_t BitBandTarget(uintptr_t address) {
+        const uintptr_t base = address & 0xF0000000U;
+        const uintptr_t byte = base + ((address - base - 0x02000000U) >> 5U);
+        return byte & ~static_cast<uintptr_t>(3U);
+    }
+
+    static uint32_t BitBandBit(uintptr_t address) {
+        const uintptr_t base = address & 0xF0000000U;
+        const uintptr_t offset = address - base - 0x02000000U;
+        return static_cast<uint32_t>(((offset >> 5U) & 3U) * 8U +
+                                     ((offset >> 2U) & 7U));
+    }
+
+    static Cell &GetCell(uintptr_t address) {
+        return File()[address];
+    }
+
+    static std::unordered_map<uintptr_t, Cell> &File() {
+        static std::unordered_map<uintptr_t, Cell> file;
+        return file;
+    }
+};
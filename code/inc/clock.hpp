@@ -0,0 +1,204 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstdint>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+
+/* Sources of the system clock for ClockConfig */
+struct ClockSource {
+    /* internal RC, 8 MHz */
+    struct Hsi {
+        static constexpr uint32_t Frequency = 8'000'000U;
+        static constexpr bool IsExternal = false;
+    };
+
+    /* external crystal or resonator, 4..16 MHz */
+    template <uint32_t frequency>
+    struct Hse {
+        static constexpr uint32_t Frequency = frequency;
+        static constexpr bool IsExternal = true;
+        static_assert(frequency >= 4'000'000U && frequency <= 16'000'000U,
+                      "HSE must be 4..16 MHz");
+    };
+};
+
+namespace Utils {
+namespace Clock {
+
+struct Pll {
+    bool used = false;
+    uint32_t preDiv = 1U;       /* 1 or 2, HSI is always divided by 2 */
+    uint32_t mul = 0U;          /* 2..16, 0 if not found */
+};
+
+constexpr Pll MakePll(uint32_t source, bool isExternal, uint32_t sysClk) {
+    Pll pll;
+    if (sysClk == source) {
+        return pll;
+    }
+    pll.used = true;
+    for (uint32_t preDiv = isExternal ? 1U : 2U; preDiv <= 2U; ++preDiv) {
+        const uint32_t input = source / preDiv;
+        if (sysClk % input == 0U && sysClk / input >= 2U &&
+            sysClk / input <= 16U) {
+            pll.preDiv = preDiv;
+            pll.mul = sysClk / input;
+            break;
+        }
+    }
+    return pll;
+}
+
+/* the smallest power of two divider, up to maxDiv */
+constexpr uint32_t MinDiv(uint32_t in, uint32_t out, uint32_t maxDiv) {
+    uint32_t div = 1U;
+    while (div < maxDiv && in / div > out) {
+        div *= 2U;
+    }
+    return div;
+}
+
+/* CFGR::HPRE code of the divider, there is no /32 */
+constexpr uint32_t HpreValue(uint32_t div) {
+    uint32_t value = 0U;
+    for (uint32_t d = 2U; d <= div; d *= 2U) {
+        value = (value == 0U) ? 0b1000U : value + ((d == 32U) ? 0U : 1U);
+    }
+    return value;
+}
+
+/* CFGR::PPRE1/PPRE2 code of the divider */
+constexpr uint32_t PpreValue(uint32_t div) {
+    uint32_t value = 0U;
+    for (uint32_t d = 2U; d <= div; d *= 2U) {
+        value = (value == 0U) ? 0b100U : value + 1U;
+    }
+    return value;
+}
+
+/* the smallest ADC prescaler (2, 4, 6, 8) for the ADC clock up to out */
+constexpr uint32_t AdcDiv(uint32_t in, uint32_t out) {
+    uint32_t div = 2U;
+    while (div < 8U && in / div > out) {
+        div += 2U;
+    }
+    return div;
+}
+
+} /* namespace Clock */
+} /* namespace Utils */
+
+/* template for ClockConfig class
+ *
+ * The whole clock tree is computed at compile time from the target
+ *   frequencies: the PLL source, predivider and multiplier, the AHB, APB1
+ *   and APB2 prescalers, and the FLASH wait states. A frequency that cannot
+ *   be reached is a compilation error.
+ *
+ * The PLL is used only if sysClk differs from the source. The APB
+ *   prescalers are the smallest that keep APB1 <= 36 MHz and APB2 <= 72 MHz,
+ *   the ADC prescaler the smallest that keeps ADCCLK <= 14 MHz.
+ *
+ * Source   - ClockSource
+ * sysClk   - SYSCLK, up to 72 MHz
+ * hClk     - AHB (HCLK), SYSCLK / 2^n
+ *
+ * Example:
+ *   using SystemClock = ClockConfig<ClockSource::Hse<8'000'000>, 72'000'000>;
+ *   SystemClock::Apply();
+ *   static_assert(SystemClock::PClk1 == 36'000'000);
+ */
+template <typename Source, uint32_t sysClk, uint32_t hClk = sysClk>
+class ClockConfig {
+    static_assert(sysClk <= 72'000'000U, "SYSCLK must be up to 72 MHz");
+
+    static constexpr uint32_t apb1Max = 36'000'000U;
+    static constexpr uint32_t apb2Max = 72'000'000U;
+    static constexpr uint32_t adcMax = 14'000'000U;
+
+    static constexpr Utils::Clock::Pll pll =
+        Utils::Clock::MakePll(Source::Frequency, Source::IsExternal, sysClk);
+    static_assert(!pll.used || pll.mul != 0U,
+                  "SYSCLK cannot be reached by the PLL from the source");
+
+    static constexpr uint32_t ahbDiv = sysClk / hClk;
+    static_assert(sysClk % hClk == 0U && ahbDiv != 0U && ahbDiv <= 512U &&
+                  ahbDiv != 32U && (ahbDiv & (ahbDiv - 1U)) == 0U,
+                  "HCLK must be SYSCLK / 1, 2, 4, 8, 16, 64, 128, 256 or 512");
+
+    static constexpr uint32_t apb1Div = Utils::Clock::MinDiv(hClk, apb1Max, 16U);
+    static constexpr uint32_t apb2Div = Utils::Clock::MinDiv(hClk, apb2Max, 16U);
+    static constexpr uint32_t adcDiv = Utils::Clock::AdcDiv(hClk / apb2Div, adcMax);
+
+public:
+    static constexpr uint32_t SysClk = sysClk;
+    static constexpr uint32_t HClk = hClk;
+    static constexpr uint32_t PClk1 = hClk / apb1Div;
+    static constexpr uint32_t PClk2 = hClk / apb2Div;
+    /* the timers run at twice PCLK if the APB is divided */
+    static constexpr uint32_t TimClk1 = (apb1Div == 1U) ? PClk1 : PClk1 * 2U;
+    static constexpr uint32_t TimClk2 = (apb2Div == 1U) ? PClk2 : PClk2 * 2U;
+    static constexpr uint32_t AdcClk = PClk2 / adcDiv;
+
+    static constexpr bool IsPllUsed = pll.used;
+    static constexpr uint32_t PllMul = pll.mul;
+    /* of SYSCLK, not HCLK (RM0008 FLASH_ACR):
+     *   0 WS up to 24 MHz, 1 WS up to 48 MHz, 2 WS above */
+    static constexpr uint32_t FlashLatency = (sysClk <= 24'000'000U) ? 0U :
+                                             (sysClk <= 48'000'000U) ? 1U : 2U;
+
+    static_assert(PClk1 <= apb1Max, "APB1 must be up to 36 MHz");
+
+    /* Switches the clock from HSI (the reset state) to the configuration
+     *
+     * FLASH latency is raised before SYSCLK, the prescalers and the PLL
+     *   setup are a single read-modify-write of CFGR.
+     */
+    static void Apply() {
+        if constexpr (Source::IsExternal) {
+            RCC::CR::HSEON::BitBand::Set();
+            while (!RCC::CR::HSERDY::BitBand::Get());
+        }
+
+        /* prefetch on, half-cycle access off */
+        FLASH::ACR::Set(FLASH::ACR::PRFTBE::Mask |
+                        (FlashLatency << FLASH::ACR::LATENCY::Offset));
+
+        RCC::CFGR::SetMasked(cfgrMask, cfgrValue);
+
+        if constexpr (pll.used) {
+            RCC::CR::PLLON::BitBand::Set();
+            while (!RCC::CR::PLLRDY::BitBand::Get());
+        }
+
+        RCC::CFGR::SetMasked(CFGR::SW::Mask, sw << CFGR::SW::Offset);
+        while (CFGR::SWS::Get() != sw);
+    }
+
+private:
+    using CFGR = RCC::CFGR;
+
+    static constexpr uint32_t sw = !pll.used ?
+        (Source::IsExternal ? CFGR::SW::HSE::Value : CFGR::SW::HSI::Value) :
+        CFGR::SW::PLL::Value;
+
+    static constexpr uint32_t cfgrMask =
+        CFGR::HPRE::Mask | CFGR::PPRE1::Mask |
+        CFGR::PPRE2::Mask | CFGR::ADCPRE::Mask |
+        (pll.used ? CFGR::PLLSRC::Mask | CFGR::PLLXTPRE::Mask |
+                    CFGR::PLLMUL::Mask : 0U);
+
+    static constexpr uint32_t cfgrValue =
+        (Utils::Clock::HpreValue(ahbDiv) << CFGR::HPRE::Offset) |
+        (Utils::Clock::PpreValue(apb1Div) << CFGR::PPRE1::Offset) |
+        (Utils::Clock::PpreValue(apb2Div) << CFGR::PPRE2::Offset) |
+        ((adcDiv / 2U - 1U) << CFGR::ADCPRE::Offset) |
+        (pll.used ?
+            ((Source::IsExternal ? 1U : 0U) << CFGR::PLLSRC::Offset) |
+            ((Source::IsExternal && pll.preDiv == 2U ? 1U : 0U) <<
+             CFGR::PLLXTPRE::Offset) |
+            ((pll.mul - 2U) << CFGR::PLLMUL::Offset) : 0U);
+};
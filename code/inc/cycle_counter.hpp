@@ -0,0 +1,37 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstdint>
+
+#include "register.hpp"
+#include "regs_cm3.hpp"
+
+/* DWT cycle counter
+ *
+ * Counts the core clock cycles, wraps every 2^32 cycles (~60 s at 72 MHz).
+ *   The differences are modulo 2^32, so Since() is correct across the wrap.
+ *
+ * Example:
+ *   CycleCounter::Enable();
+ *   const uint32_t start = CycleCounter::Now();
+ *   Led::Toggle();
+ *   const uint32_t cycles = CycleCounter::Since(start);
+ */
+class CycleCounter {
+public:
+    static void Enable() {
+        /* DWT is powered by the trace enable */
+        CoreDebug::DEMCR::TRCENA::Enable::Set();
+        DWT::CYCCNT::Set(0U);
+        DWT::CTRL::CYCCNTENA::Enable::Set();
+    }
+
+    static inline uint32_t Now() {
+        return DWT::CYCCNT::Get();
+    }
+
+    static inline uint32_t Since(uint32_t start) {
+        return Now() - start;
+    }
+};
@@ -0,0 +1,131 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "utils.hpp"
+#include "pin.hpp"
+
+/* template for PortDebouncer class
+ *
+ * Debounces the whole port at once. Every pin has a 2-bit counter, and the
+ *   counters are vertical: bit 0 of all the pins is one word, bit 1 another,
+ *   so a tick is one IDR load and a few boolean operations for all 16 pins.
+ *   A pin changes its state after 4 ticks in a row with the new level, any
+ *   tick with the old level restarts the count.
+ *
+ * Tick() runs at a fixed rate, from a timer interrupt or the main loop:
+ *   at 5 ms a bounce up to 15 ms is filtered and a change is seen in 20 ms.
+ *   Edges are accumulated until taken, so a slow main loop loses no press.
+ *
+ * PortT    - port template from port.hpp
+ * mask     - the pins to debounce, the others read as 0
+ *
+ * Example:
+ *   using Keys = PortDebouncer<Port<GPIOB>, 0x00F0>;
+ *   using Ok = Keys::Input<Pin<Port<GPIOB>, 4, PinMode::Read>>;
+ *   Keys::Init();
+ *   Keys::Tick();              // every 5 ms
+ *   if (Ok::TakeFalling()) {}  // pressed, active low
+ */
+template <typename PortT, uint32_t mask = 0xFFFFU>
+class PortDebouncer {
+public:
+    using PortType = PortT;
+    static constexpr uint32_t Mask = mask;
+
+    /* the debounced level of a pin, with the access checks of the pin */
+    template <typename PinT>
+    class Input {
+        static_assert(std::is_same_v<typename PinT::PortType, PortT>,
+                      "The pin is on another port");
+        static_assert((mask & (1U << PinT::Number)) != 0U,
+                      "The pin is not debounced");
+        static_assert(std::is_base_of_v<PinMode::Read, typename PinT::Access>,
+                      "The pin is not readable");
+
+        static constexpr uint32_t bit = 1U << PinT::Number;
+
+    public:
+        using PinType = PinT;
+
+        static inline uint32_t Get() {
+            return (State() & bit) >> PinT::Number;
+        }
+
+        static inline bool TakeRising() {
+            return PortDebouncer::TakeRising(bit) != 0U;
+        }
+
+        static inline bool TakeFalling() {
+            return PortDebouncer::TakeFalling(bit) != 0U;
+        }
+    };
+
+    /* the current levels are taken as stable, no edges */
+    static void Init() {
+        state = Sample();
+        count0 = 0U;
+        count1 = 0U;
+        rising = 0U;
+        falling = 0U;
+    }
+
+    /* returns the pins changed on this tick */
+    static uint32_t Tick() {
+        const uint32_t delta = Sample() ^ state;
+
+        /* count up the pins that differ, clear the others */
+        count1 = (count1 ^ count0) & delta;
+        count0 = ~count0 & delta;
+
+        /* the counter has wrapped: the 4th different sample in a row */
+        const uint32_t changed = delta & ~(count0 | count1);
+        const uint32_t newState = state ^ changed;
+
+        state = newState;
+        rising = rising | (changed & newState);
+        falling = falling | (changed & ~newState);
+        return changed;
+    }
+
+    static inline uint32_t State() {
+        return state;
+    }
+
+    /* the pins of the bits that went high since the last call, cleared */
+    static uint32_t TakeRising(uint32_t bits = mask) {
+        return Take(rising, bits);
+    }
+
+    static uint32_t TakeFalling(uint32_t bits = mask) {
+        return Take(falling, bits);
+    }
+
+private:
+    static_assert(mask != 0U && mask <= 0xFFFFU, "There are only 16 pins on port");
+
+    static inline uint32_t Sample() {
+        return static_cast<uint32_t>(PortT::Get()) & mask;
+    }
+
+    /* Tick() may run in an interrupt */
+    static uint32_t Take(volatile uint32_t &events, uint32_t bits) {
+        const uint32_t primask = Utils::Sync::__get_primask();
+        Utils::Sync::__disable_irq();
+
+        const uint32_t taken = events & bits;
+        events = events & ~taken;
+
+        Utils::Sync::__set_primask(primask);
+        return taken;
+    }
+
+    static inline volatile uint32_t state = 0U;
+    static inline uint32_t count0 = 0U;     /* Tick() only */
+    static inline uint32_t count1 = 0U;
+    static inline volatile uint32_t rising = 0U;
+    static inline volatile uint32_t falling = 0U;
+};
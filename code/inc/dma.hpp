@@ -0,0 +1,79 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+#include "vectors.hpp"
+
+/* template for DmaChannel class
+ *
+ * A channel of DMA1. The configuration is a list of CCR FieldValues folded
+ *   into one word at compile time, so Configure() is a single store.
+ *
+ * n - channel, 1..7
+ *
+ * Example:
+ *   using Tx = DmaChannel<4>;
+ *   Tx::Configure<Tx::CCR::DIR::FromMemory, Tx::CCR::MINC::Enable,
+ *                 Tx::CCR::TCIE::Enable>(USART1::DR::Address);
+ *   Tx::Start(data, size);
+ */
+template <uint32_t n>
+class DmaChannel {
+public:
+    using Regs = typename DMA1::template Channel<n>;
+    using CCR = typename Regs::CCR;
+    using Flags = typename DMA1::template Flags<n>;
+
+    static constexpr IrqN Irq = static_cast<IrqN>(
+        static_cast<int32_t>(IrqN::DMA1_Channel1) + static_cast<int32_t>(n) - 1);
+
+    /* CCR word of the FieldValues */
+    template <typename... Values>
+    static constexpr uint32_t Ccr =
+        ((static_cast<uint32_t>(Values::Value) << Values::Offset) | ... | 0U);
+
+    /* the channel is stopped, the interrupt flags are cleared */
+    template <typename... Values>
+    static void Configure(uintptr_t peripheral) {
+        static_assert(((std::is_same_v<typename Values::Register, CCR>) && ...),
+                      "Only the values of the channel CCR");
+        static_assert((Ccr<Values...> & CCR::EN::Mask) == 0U,
+                      "The channel is enabled by Start()");
+
+        CCR::Set(Ccr<Values...>);
+        ClearFlags(Flags::GIF);
+        Regs::CPAR::Set(static_cast<uint32_t>(peripheral));
+    }
+
+    /* count - up to 65535 transfers */
+    static void Start(const volatile void *memory, uint32_t count) {
+        Regs::CMAR::Set(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(memory)));
+        Regs::CNDTR::Set(count);
+        CCR::EN::BitBand::Set();
+    }
+
+    /* CNDTR and CMAR are writable only while the channel is stopped */
+    static inline void Stop() {
+        CCR::EN::BitBand::Reset();
+    }
+
+    /* the transfers left, reloaded in circular mode */
+    static inline uint32_t Remaining() {
+        return Regs::CNDTR::Get();
+    }
+
+    static inline uint32_t GetFlags() {
+        return DMA1::ISR::Get() & (Flags::GIF | Flags::TCIF |
+                                   Flags::HTIF | Flags::TEIF);
+    }
+
+    /* one store, IFCR is one-to-clear */
+    static inline void ClearFlags(uint32_t flags) {
+        DMA1::IFCR::Set(flags);
+    }
+};
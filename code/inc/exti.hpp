@@ -0,0 +1,156 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+#include "regs_cm3.hpp"
+#include "nvic.hpp"
+#include "pin.hpp"
+
+/* Edge of the external interrupt */
+enum class ExtiEdge {
+    Rising,
+    Falling,
+    Both
+};
+
+/* template for ExtiLine class
+ *
+ * line - EXTI line, the same as the pin number
+ */
+template <uint32_t line>
+class ExtiLine {
+public:
+    static_assert(line <= 15U, "There are only 16 GPIO EXTI lines");
+
+    /* NVIC interrupt of the line */
+    static constexpr IrqN Irq =
+        (line < 5U)  ? static_cast<IrqN>(static_cast<int32_t>(IrqN::EXTI0) + line) :
+        (line < 10U) ? IrqN::EXTI9_5 :
+                       IrqN::EXTI15_10;
+
+    static constexpr uint32_t Mask = 1U << line;
+
+    /* one store, PR is one-to-clear */
+    static inline void Clear() {
+        EXTI::PR::Set(Mask);
+    }
+
+    static inline bool IsPending() {
+        return (EXTI::PR::Get() & Mask) != 0U;
+    }
+
+    /* one store, SWIER is one-to-set */
+    static inline void Trigger() {
+        EXTI::SWIER::Set(Mask);
+    }
+};
+
+/* Interrupt configuration of one pin for ExtiSetup
+ *
+ * PinT - Pin from pin.hpp, must be configurable
+ * edge - ExtiEdge
+ */
+template <typename PinT, ExtiEdge edge>
+struct ExtiConfig {
+    using PinType = PinT;
+    static constexpr ExtiEdge Edge = edge;
+    static constexpr uint32_t Line = PinT::Number;
+};
+
+/* EXTI setup
+ *
+ * Routes the pins to their EXTI lines, selects the edges, unmasks the lines
+ *   and enables the NVIC interrupts. Every register is written once,
+ *   all the masks are computed at compile time.
+ *
+ * An EXTI line is shared by the pins with the same number on all the ports,
+ *   so two pins with the same number cannot be listed (compilation error).
+ *   The check covers one list: like VectorTable and Board, the application
+ *   has one ExtiSetup with all its EXTI pins. A second ExtiSetup with a pin
+ *   of the same number routes the line away from the first one.
+ *
+ * Configs - ExtiConfigs
+ *
+ * Example:
+ *   ExtiSetup<ExtiConfig<Button, ExtiEdge::Both>>::Init();
+ */
+template <typename... Configs>
+class ExtiSetup {
+public:
+    static constexpr uint32_t LinesMask = (ExtiLine<Configs::Line>::Mask | ...);
+
+    static void Init() {
+        /* AFIO clock is required by EXTICR */
+        RCC::APB2ENR::AFIOEN::BitBand::Set();
+
+        SetExticr<0U>();
+        SetExticr<1U>();
+        SetExticr<2U>();
+        SetExticr<3U>();
+
+        EXTI::RTSR::SetMasked(LinesMask, EdgeMask<ExtiEdge::Rising>());
+        EXTI::FTSR::SetMasked(LinesMask, EdgeMask<ExtiEdge::Falling>());
+
+        /* drop the events of the configuration, then unmask */
+        EXTI::PR::Set(LinesMask);
+        EXTI::IMR::SetMasked(LinesMask, LinesMask);
+
+        if constexpr (IserMask<0U>() != 0U) {
+            NVIC::ISER<0U>::Set(IserMask<0U>());
+        }
+        if constexpr (IserMask<1U>() != 0U) {
+            NVIC::ISER<1U>::Set(IserMask<1U>());
+        }
+    }
+
+private:
+    static_assert(sizeof...(Configs) > 0U, "ExtiSetup cannot be empty");
+
+    static_assert((std::is_base_of_v<PinMode::Config,
+                                     typename Configs::PinType::Access> && ...),
+                  "All the pins must be configurable");
+
+    template <typename T>
+    static constexpr size_t countOf = ((T::Line == Configs::Line) + ...);
+    static_assert(((countOf<Configs> == 1U) && ...),
+                  "Two pins claim the same EXTI line");
+
+    template <uint32_t n>
+    static constexpr uint32_t ExticrMask() {
+        return ((Configs::Line / 4U == n ?
+                 0xFU << ((Configs::Line % 4U) * 4U) : 0U) | ...);
+    }
+
+    template <uint32_t n>
+    static constexpr uint32_t ExticrValue() {
+        return ((Configs::Line / 4U == n ?
+                 Configs::PinType::PortType::Regs::Index <<
+                 ((Configs::Line % 4U) * 4U) : 0U) | ...);
+    }
+
+    template <uint32_t n>
+    static inline void SetExticr() {
+        if constexpr (ExticrMask<n>() != 0U) {
+            AFIO::EXTICR<n>::SetMasked(ExticrMask<n>(), ExticrValue<n>());
+        }
+    }
+
+    template <ExtiEdge edge>
+    static constexpr uint32_t EdgeMask() {
+        return ((Configs::Edge == edge || Configs::Edge == ExtiEdge::Both ?
+                 ExtiLine<Configs::Line>::Mask : 0U) | ...);
+    }
+
+    template <uint32_t n>
+    static constexpr uint32_t IserMask() {
+        return ((static_cast<uint32_t>(ExtiLine<Configs::Line>::Irq) / 32U == n ?
+                 1U << (static_cast<uint32_t>(ExtiLine<Configs::Line>::Irq) % 32U) :
+                 0U) | ...);
+    }
+};
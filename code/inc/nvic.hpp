@@ -0,0 +1,162 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "register.hpp"
+#include "regs_cm3.hpp"
+#include "vectors.hpp"
+
+/* Priority grouping
+ *
+ * STM32F103 implements 4 priority bits. preemptBits of them are the
+ *   preemption priority, the rest are the subpriority.
+ */
+template <uint32_t preemptBits = 4U>
+struct NvicGrouping {
+    static constexpr uint32_t PriorityBits = 4U;
+    static constexpr uint32_t PreemptBits = preemptBits;
+    static constexpr uint32_t SubBits = PriorityBits - preemptBits;
+    static_assert(preemptBits <= PriorityBits, "There are only 4 priority bits");
+
+    /* AIRCR::PRIGROUP, the binary point of the 8-bit priority */
+    static constexpr uint32_t PriGroup = 7U - preemptBits;
+
+    template <uint32_t preempt, uint32_t sub>
+    static constexpr uint8_t Encode() {
+        static_assert(preempt < (1U << PreemptBits), "Preemption priority is too big");
+        static_assert(sub < (1U << SubBits), "Subpriority is too big");
+
+        return static_cast<uint8_t>(((preempt << SubBits) | sub) <<
+                                    (8U - PriorityBits));
+    }
+
+    static void Apply() {
+        SCB::AIRCR::Set(SCB::AIRCR::VectKey |
+                        (PriGroup << SCB::AIRCR::PriGroupOffset));
+    }
+};
+
+/* template for Nvic class
+ *
+ * irq - the exception or interrupt from vectors.hpp
+ *
+ * Every call is a single store: the set/clear registers ignore zero bits.
+ */
+template <IrqN irq>
+class Nvic {
+public:
+    static inline void Enable() {
+        CheckIrq();
+
+        NVIC::ISER<index>::Set(bit);
+    }
+
+    static inline void Disable() {
+        CheckIrq();
+
+        NVIC::ICER<index>::Set(bit);
+    }
+
+    static inline bool IsEnabled() {
+        CheckIrq();
+
+        return (NVIC::ISER<index>::Get() & bit) != 0U;
+    }
+
+    static inline void SetPending() {
+        CheckIrq();
+
+        NVIC::ISPR<index>::Set(bit);
+    }
+
+    static inline void ClearPending() {
+        CheckIrq();
+
+        NVIC::ICPR<index>::Set(bit);
+    }
+
+    static inline bool IsPending() {
+        CheckIrq();
+
+        return (NVIC::ISPR<index>::Get() & bit) != 0U;
+    }
+
+    /* works for the configurable core exceptions as well */
+    template <uint32_t preempt, uint32_t sub = 0U,
+              typename Grouping = NvicGrouping<>>
+    static inline void SetPriority() {
+        constexpr uint8_t priority = Grouping::template Encode<preempt, sub>();
+
+        if constexpr (number >= 0) {
+            NVIC::IPR<static_cast<uint32_t>(number)>::Set(priority);
+        } else {
+            static_assert(number >= static_cast<int32_t>(IrqN::MemoryManagement),
+                          "The priority of the exception is fixed");
+            SCB::SHPR<static_cast<uint32_t>(number + 16)>::Set(priority);
+        }
+    }
+
+private:
+    static constexpr int32_t number = static_cast<int32_t>(irq);
+    static constexpr uint32_t index = (number >= 0) ?
+                                      static_cast<uint32_t>(number) / 32U : 0U;
+    static constexpr uint32_t bit = (number >= 0) ?
+                                    1U << (static_cast<uint32_t>(number) % 32U) : 0U;
+
+    static constexpr void CheckIrq() {
+        static_assert(number >= 0, "Core exceptions are always enabled");
+    }
+};
+
+/* Interrupt setup for NvicSetup
+ *
+ * irq      - the interrupt
+ * preempt  - preemption priority
+ * sub      - subpriority
+ */
+template <IrqN irq, uint32_t preempt, uint32_t sub = 0U>
+struct IrqPriority {
+    static constexpr IrqN Irq = irq;
+    static constexpr uint32_t Preempt = preempt;
+    static constexpr uint32_t Sub = sub;
+};
+
+/* NVIC setup of the application
+ *
+ * The grouping and all the priorities are checked and encoded at compile
+ *   time, Apply() is a store per register. The interrupts are enabled
+ *   after their priorities are set.
+ *
+ * Grouping   - NvicGrouping
+ * Priorities - IrqPriority list
+ *
+ * Example:
+ *   NvicSetup<NvicGrouping<2>,
+ *             IrqPriority<IrqN::EXTI1, 1, 0>,
+ *             IrqPriority<IrqN::SysTick, 0, 0>>::Apply();
+ */
+template <typename Grouping, typename... Priorities>
+struct NvicSetup {
+    static void Apply() {
+        Grouping::Apply();
+        (Nvic<Priorities::Irq>::template SetPriority<
+            Priorities::Preempt, Priorities::Sub, Grouping>(), ...);
+        (EnableIrq<Priorities::Irq>(), ...);
+    }
+
+private:
+    template <typename T>
+    static constexpr size_t countOf = ((T::Irq == Priorities::Irq) + ...);
+    static_assert(((countOf<Priorities> == 1U) && ...),
+                  "An interrupt is listed twice");
+
+    template <IrqN irq>
+    static inline void EnableIrq() {
+        if constexpr (static_cast<int32_t>(irq) >= 0) {
+            Nvic<irq>::Enable();
+        }
+    }
+};
@@ -38,6 +38,11 @@ struct PinMode {
 };
 
 
+/* EXTI, see exti.hpp */
+template <uint32_t line>
+class ExtiLine;
+
+
 /* template for Pin class
  *
  * Port         - port template from port.hpp
@@ -47,6 +52,11 @@ struct PinMode {
 template <typename Port, uint8_t pinNum, typename AccessMode>
 class Pin {
 public:
+    /* declared here to be visible outside */
+    using PortType = Port;
+    using Access = AccessMode;
+    static constexpr uint8_t Number = pinNum;
+
     enum class InputMode {
         PullUp,
         PullDown
@@ -76,18 +86,29 @@ public:
         ResetInternal();
     }
 
+    /* Sync - concurrency policy of the config update, see sync.hpp */
+    template <typename Sync = Utils::Sync::Exclusive>
     static void ConfigOutput() {
         CheckMode<PinMode::Config>();
 
-        Port::SetOutput(pinNum);
+        Port::template SetOutput<Sync>(pinNum);
     }
 
-    template <InputMode InMode = InputMode::PullUp>
+    /* the pin is driven by its peripheral */
+    template <typename Sync = Utils::Sync::Exclusive>
+    static void ConfigAlternate() {
+        CheckMode<PinMode::Config>();
+
+        Port::template SetAlternate<Sync>(pinNum);
+    }
+
+    template <InputMode InMode = InputMode::PullUp,
+              typename Sync = Utils::Sync::Exclusive>
     static void ConfigInput() {
         CheckMode<PinMode::Config>();
 
         /* init as input */
-        Port::SetInput(pinNum);
+        Port::template SetInput<Sync>(pinNum);
 
         /* push-pull */
         if constexpr (InMode == InputMode::PullDown) {
@@ -98,6 +119,22 @@ public:
             static_assert(Utils::dependentBool<false>, "Unknown Pin mode");
         }
     }
+
+    /* External interrupt of the pin, include exti.hpp to use it.
+     * The pin is configured by the ExtiSetup of the application.
+     */
+    static inline bool IsInterruptPending() {
+        CheckMode<PinMode::Read>();
+
+        return ExtiLine<pinNum>::IsPending();
+    }
+
+    static inline void ClearInterrupt() {
+        CheckMode<PinMode::Read>();
+
+        ExtiLine<pinNum>::Clear();
+    }
+
 private:
     static constexpr uint8_t pinNumMax = 15;
     static_assert(pinNum <= pinNumMax, "There are only 16 pins on port");
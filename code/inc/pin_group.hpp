@@ -0,0 +1,261 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "utils.hpp"
+#include "pin.hpp"
+
+/* template for PinGroup class
+ *
+ * Drives several pins at once. The pins are grouped by port at compile time,
+ *   and every port gets exactly one BSRR store, so all the pins of a port
+ *   change simultaneously. Read() is the other way round: one IDR load per
+ *   port, all the loads back-to-back, then the bits are packed.
+ *
+ * Pins - Pin types from pin.hpp, the order defines the bits of Write()
+ *
+ * Example:
+ *   using Leds = PinGroup<Pin<Port<GPIOA>, 0, PinMode::Write>,
+ *                         Pin<Port<GPIOB>, 5, PinMode::Write>,
+ *                         Pin<Port<GPIOA>, 3, PinMode::Write>>;
+ *   Leds::Set();           // GPIOA::BSRR = 0x09, GPIOB::BSRR = 0x20
+ *   Leds::Write(0b010);    // PB5 high, PA0 and PA3 low
+ *
+ *   using Keys = PinGroup<Pin<Port<GPIOA>, 4, PinMode::Read>,
+ *                         Pin<Port<GPIOA>, 5, PinMode::Read>,
+ *                         Pin<Port<GPIOC>, 0, PinMode::Read>>;
+ *   Keys::Read();          // ((IDRA >> 4) & 0b11) | ((IDRC & 1) << 2)
+ */
+template <typename... Pins>
+class PinGroup {
+public:
+    static constexpr size_t Size = sizeof...(Pins);
+
+    static inline void Set() {
+        CheckMode<PinMode::Write>();
+
+        ForEachPort([](auto port) {
+            using P = decltype(port);
+            P::Type::Set(PortMask<typename P::Type>());
+        });
+    }
+
+    static inline void Reset() {
+        CheckMode<PinMode::Write>();
+
+        ForEachPort([](auto port) {
+            using P = decltype(port);
+            P::Type::Set(PortMask<typename P::Type>() << 16U);
+        });
+    }
+
+    /* one ODR load and one BSRR store per port */
+    static inline void Toggle() {
+        CheckMode<PinMode::Write>();
+
+        ForEachPort([](auto port) {
+            using P = decltype(port);
+            constexpr uint32_t mask = PortMask<typename P::Type>();
+            const uint32_t odr = P::Type::GetOutput();
+            P::Type::Set((~odr & mask) | ((odr & mask) << 16U));
+        });
+    }
+
+    /* bit N of the value goes to the N-th pin of the group */
+    static inline void Write(uint32_t value) {
+        CheckMode<PinMode::Write>();
+
+        ForEachPort([value](auto port) {
+            using P = decltype(port);
+            P::Type::Set(PortBsrr<typename P::Type>(
+                value, std::index_sequence_for<Pins...>{}));
+        });
+    }
+
+    /* a snapshot of the pins, bit N is the N-th pin of the group */
+    static inline uint32_t Read() {
+        CheckMode<PinMode::Read>();
+
+        return ReadPorts(std::make_index_sequence<PortCount()>{});
+    }
+
+    /* the BSRR word of the value for the port P */
+    template <typename P>
+    static constexpr uint32_t Bsrr(uint32_t value) {
+        return PortBsrr<P>(value, std::index_sequence_for<Pins...>{});
+    }
+
+    /* the number of the ports */
+    static constexpr size_t PortCount() {
+        return CountPorts(std::index_sequence_for<Pins...>{});
+    }
+
+private:
+    static_assert(Size > 0U, "PinGroup cannot be empty");
+
+    template <typename T>
+    static constexpr size_t countOf =
+        ((std::is_same_v<typename T::PortType, typename Pins::PortType> &&
+          T::Number == Pins::Number) + ...);
+    static_assert(((countOf<Pins> == 1U) && ...), "A pin is listed twice");
+
+    template <size_t i>
+    using PinAt = std::tuple_element_t<i, std::tuple<Pins...>>;
+
+public:
+    /* the port of the first pin, the port of the group if PortCount() is 1 */
+    using PortType = typename PinAt<0>::PortType;
+
+private:
+    template <typename T>
+    struct PortTag {
+        using Type = T;
+    };
+
+    /* Check the mode of every pin, instead of SFINAE */
+    template <typename T>
+    static constexpr void CheckMode() {
+        static_assert((std::is_base_of_v<T, typename Pins::Access> && ...));
+    }
+
+    template <typename P>
+    static constexpr uint32_t PortMask() {
+        return ((std::is_same_v<P, typename Pins::PortType> ?
+                 (1U << Pins::Number) : 0U) | ...);
+    }
+
+    template <typename P, size_t... I>
+    static constexpr uint32_t PortBsrr(uint32_t value, std::index_sequence<I...>) {
+        uint32_t bsrr = 0U;
+        ((std::is_same_v<P, typename PinAt<I>::PortType> ?
+          (bsrr |= ((value >> I) & 1U) ?
+                   (1U << PinAt<I>::Number) :
+                   (1U << PinAt<I>::Number) << 16U) :
+          0U), ...);
+        return bsrr;
+    }
+
+    /* the pin is the first one of its port in the group */
+    template <size_t i>
+    static constexpr bool IsFirstOfPort() {
+        constexpr bool samePort[] = {
+            std::is_same_v<typename PinAt<i>::PortType, typename Pins::PortType>...
+        };
+        for (size_t j = 0; j < i; ++j) {
+            if (samePort[j]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <size_t... I>
+    static constexpr size_t CountPorts(std::index_sequence<I...>) {
+        return (IsFirstOfPort<I>() + ...);
+    }
+
+    /* Read plan: the pins of a port with the same distance between the pin
+     *   number and the bit of the group are one run, extracted by one mask
+     *   and one shift. Adjacent pins in the group order always merge.
+     */
+    struct Run {
+        size_t port;        /* index of the loaded IDR */
+        uint32_t mask;      /* the pins in IDR */
+        int32_t shift;      /* bit of the group - pin number */
+    };
+
+    struct Plan {
+        size_t runs = 0U;
+        Run run[Size] = {};
+        size_t firstPin[Size] = {};  /* a pin of every port, by port index */
+    };
+
+    template <size_t... I>
+    static constexpr Plan MakePlan(std::index_sequence<I...>) {
+        constexpr uintptr_t portOf[] = {PinAt<I>::PortType::Regs::IDR::Address...};
+        constexpr uint32_t number[] = {PinAt<I>::Number...};
+
+        Plan plan;
+        uintptr_t ports[Size] = {};
+        size_t portCount = 0U;
+
+        for (size_t i = 0; i < Size; ++i) {
+            size_t port = 0U;
+            while (port < portCount && ports[port] != portOf[i]) {
+                ++port;
+            }
+            if (port == portCount) {
+                ports[portCount] = portOf[i];
+                plan.firstPin[portCount++] = i;
+            }
+
+            const int32_t shift = static_cast<int32_t>(i) -
+                                  static_cast<int32_t>(number[i]);
+            size_t r = 0U;
+            while (r < plan.runs &&
+                   (plan.run[r].port != port || plan.run[r].shift != shift)) {
+                ++r;
+            }
+            if (r == plan.runs) {
+                plan.run[plan.runs++] = {port, 0U, shift};
+            }
+            plan.run[r].mask |= 1U << number[i];
+        }
+        return plan;
+    }
+
+    static constexpr Plan ReadPlan() {
+        return MakePlan(std::index_sequence_for<Pins...>{});
+    }
+
+    template <size_t r>
+    static inline uint32_t Extract(const uint32_t *idr) {
+        constexpr Run run = ReadPlan().run[r];
+        const uint32_t bits = idr[run.port] & run.mask;
+        if constexpr (run.shift >= 0) {
+            return bits << run.shift;
+        } else {
+            return bits >> -run.shift;
+        }
+    }
+
+    template <size_t... R>
+    static inline uint32_t Pack(const uint32_t *idr, std::index_sequence<R...>) {
+        return (Extract<R>(idr) | ...);
+    }
+
+    template <size_t... P>
+    static inline uint32_t ReadPorts(std::index_sequence<P...>) {
+        static_assert(Size <= 32U, "Up to 32 pins can be read at once");
+
+        /* the loads first, in a row, for a coherent snapshot */
+        const uint32_t idr[] = {
+            static_cast<uint32_t>(
+                PinAt<ReadPlan().firstPin[P]>::PortType::Get())...
+        };
+        return Pack(idr, std::make_index_sequence<ReadPlan().runs>{});
+    }
+
+    template <size_t i, typename Func>
+    static inline void VisitPort(Func &func) {
+        if constexpr (IsFirstOfPort<i>()) {
+            func(PortTag<typename PinAt<i>::PortType>{});
+        }
+    }
+
+    template <typename Func, size_t... I>
+    static inline void ForEachPort(Func &&func, std::index_sequence<I...>) {
+        (VisitPort<I>(func), ...);
+    }
+
+    template <typename Func>
+    static inline void ForEachPort(Func &&func) {
+        ForEachPort(func, std::index_sequence_for<Pins...>{});
+    }
+};
@@ -7,14 +7,18 @@
 
 #include "utils.hpp"
 #include "register.hpp"
+#include "sync.hpp"
 
 
 /* template for Port class
  *
+ * T - GPIO registers from regs_f103.hpp
  */
 template <typename T>
 class Port {
 public:
+    using Regs = T;
+
     static inline constexpr void Toggle(uint32_t value) {
         T::ODR::Toggle(static_cast<typename T::ODR::Type>(value));
     }
@@ -27,34 +31,56 @@ public:
         return T::IDR::Get();
     }
 
-    static constexpr void SetOutput(uint32_t pinNum) {
-        assert(pinNum <= pinNumMax);
+    static inline constexpr auto GetOutput() {
+        return T::ODR::Get();
+    }
 
-        using Type = typename T::CRL::Type;
-        using Field = typename T::CRL::FieldValues::OutPP50MHz;
+    /* Sync - concurrency policy of the CRL/CRH update, see sync.hpp
+     *
+     * The configuration helpers are always inlined: -Og would call them,
+     *   a call per pin setup on top of the read-modify-write.
+     */
+    template <typename Sync = Utils::Sync::Exclusive>
+    __attribute__((always_inline)) static constexpr void SetOutput(uint32_t pinNum) {
+        SetConfig<typename T::CRL::FieldValues::OutPP50MHz, Sync>(pinNum);
+    }
+
+    /* push-pull output driven by a peripheral (USART TX, timer channel) */
+    template <typename Sync = Utils::Sync::Exclusive>
+    __attribute__((always_inline)) static constexpr void SetAlternate(uint32_t pinNum) {
+        SetConfig<typename T::CRL::FieldValues::AltPP50MHz, Sync>(pinNum);
+    }
 
-        Utils::Sync::Atomic<Type>::Set(
-            T::CRL::Address,
-            Field::Mask,
-            Field::Value,
-            static_cast<Type>(pinNum * 4U)
-        );
+    template <typename Sync = Utils::Sync::Exclusive>
+    __attribute__((always_inline)) static constexpr void SetInput(uint8_t pinNum) {
+        SetConfig<typename T::CRL::FieldValues::InPushPull, Sync>(pinNum);
     }
 
-    static constexpr void SetInput(uint8_t pinNum) {
+    /* pins 0..7 are configured by CRL, pins 8..15 by CRH */
+    template <typename Field, typename Sync = Utils::Sync::Exclusive>
+    __attribute__((always_inline)) static constexpr void SetConfig(uint32_t pinNum) {
         assert(pinNum <= pinNumMax);
 
         using Type = typename T::CRL::Type;
-        using Field = typename T::CRL::FieldValues::InPushPull;
 
-        Utils::Sync::Atomic<Type>::Set(
-            T::CRL::Address,
-            Field::Mask,
-            Field::Value,
-            static_cast<Type>(pinNum * 4U)
-        );
+        if (pinNum < pinsPerCr) {
+            Utils::Sync::Atomic<Type, typename T::CRL::Bus, Sync>::Set(
+                T::CRL::Address,
+                Field::Mask,
+                Field::Value,
+                static_cast<Type>(pinNum * 4U)
+            );
+        } else {
+            Utils::Sync::Atomic<Type, typename T::CRH::Bus, Sync>::Set(
+                T::CRH::Address,
+                Field::Mask,
+                Field::Value,
+                static_cast<Type>((pinNum - pinsPerCr) * 4U)
+            );
+        }
     }
 
 private:
     static constexpr uint32_t pinNumMax = 15;
+    static constexpr uint32_t pinsPerCr = 8;
 };
@@ -0,0 +1,164 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "utils.hpp"
+#include "sync.hpp"
+#include "pin.hpp"
+#include "board.hpp"
+
+/* template for PortBus class
+ *
+ * Adjacent pins of one port as a parallel bus (LCD, FPGA, R-2R DAC).
+ *   Bit 0 of the value is the first pin. All the masks and shifts are
+ *   constants, so:
+ *    - Write() is one BSRR store: every bus pin is in the reset half, the
+ *      set bits of the value in the set half. BSx has priority over BRx,
+ *      so no inverted copy of the value is needed;
+ *    - Read() is one IDR load, a shift and a mask;
+ *    - a direction change is one RMW of CRL and/or CRH, or a plain store
+ *      when the bus covers the whole register.
+ *
+ * PortT        - port template from port.hpp
+ * firstPin     - the pin of bit 0
+ * width        - the number of pins, up to 16
+ * AccessMode   - allowed PinModes, see pin.hpp
+ *
+ * Example:
+ *   using Data = PortBus<Port<GPIOB>, 8, 8>;     // PB8..PB15
+ *   Data::ConfigOutput();                        // GPIOB::CRH = 0x33333333
+ *   Data::Write(0xA5);                           // GPIOB::BSRR = 0xFF00A500
+ *   Data::ConfigInput<Data::InputMode::PullUp>();
+ *   const uint32_t status = Data::Read();        // (IDR >> 8) & 0xFF
+ */
+template <typename PortT, uint8_t firstPin, uint8_t width,
+          typename AccessMode = PinMode::Allmighty>
+class PortBus {
+public:
+    using PortType = PortT;
+    using Access = AccessMode;
+    static constexpr uint8_t First = firstPin;
+    static constexpr uint8_t Width = width;
+
+    /* the largest value of the bus */
+    static constexpr uint32_t Max = (1U << width) - 1U;
+    /* the pins of the bus in the port */
+    static constexpr uint32_t Mask = Max << firstPin;
+
+    enum class InputMode {
+        PullUp,
+        PullDown,
+        Float
+    };
+
+    /* bits above the width are dropped */
+    static inline void Write(uint32_t value) {
+        CheckMode<PinMode::Write>();
+
+        PortT::Set((Mask << 16U) | ((value & Max) << firstPin));
+    }
+
+    static inline void Set() {
+        CheckMode<PinMode::Write>();
+
+        PortT::Set(Mask);
+    }
+
+    static inline void Reset() {
+        CheckMode<PinMode::Write>();
+
+        PortT::Set(Mask << 16U);
+    }
+
+    static inline uint32_t Read() {
+        CheckMode<PinMode::Read>();
+
+        return (static_cast<uint32_t>(PortT::Get()) >> firstPin) & Max;
+    }
+
+    /* the value being driven, from ODR */
+    static inline uint32_t ReadOutput() {
+        CheckMode<PinMode::Write>();
+
+        return (static_cast<uint32_t>(PortT::GetOutput()) >> firstPin) & Max;
+    }
+
+    /* Setup - PinSetup mode from board.hpp, applied to every pin:
+     *   ODR first (one BSRR store), then CRL/CRH.
+     * Sync  - concurrency policy of the CRL/CRH update, see sync.hpp
+     */
+    template <typename Setup, typename Sync = Utils::Sync::Exclusive>
+    static void Config() {
+        CheckMode<PinMode::Config>();
+
+        using Regs = typename PortT::Regs;
+
+        if constexpr (Setup::Odr == 1) {
+            PortT::Set(Mask);
+        } else if constexpr (Setup::Odr == 0) {
+            PortT::Set(Mask << 16U);
+        }
+        if constexpr (CrMask(0U) != 0U) {
+            Regs::CRL::template SetMasked<Sync>(CrMask(0U),
+                                                CrWord<Setup>(0U));
+        }
+        if constexpr (CrMask(pinsPerCr) != 0U) {
+            Regs::CRH::template SetMasked<Sync>(CrMask(pinsPerCr),
+                                                CrWord<Setup>(pinsPerCr));
+        }
+    }
+
+    /* push-pull, the output levels are kept */
+    template <typename Sync = Utils::Sync::Exclusive>
+    static void ConfigOutput() {
+        Config<PinSetup::Mode<Cr::OutPP50MHz, -1>, Sync>();
+    }
+
+    template <InputMode InMode = InputMode::Float,
+              typename Sync = Utils::Sync::Exclusive>
+    static void ConfigInput() {
+        if constexpr (InMode == InputMode::PullUp) {
+            Config<PinSetup::InputPullUp, Sync>();
+        } else if constexpr (InMode == InputMode::PullDown) {
+            Config<PinSetup::InputPullDown, Sync>();
+        } else if constexpr (InMode == InputMode::Float) {
+            Config<PinSetup::InputFloat, Sync>();
+        } else {
+            static_assert(Utils::dependentBool<false>, "Unknown input mode");
+        }
+    }
+
+private:
+    static constexpr uint32_t pinsPerCr = 8U;
+    static constexpr uint32_t pinNumMax = 15U;
+
+    static_assert(width > 0U && firstPin + width <= pinNumMax + 1U,
+                  "The bus must fit in the 16 pins of the port");
+
+    using Cr = GPIOA::CRL::FieldValues;
+
+    /* Check the mode, instead of SFINAE */
+    template <typename T>
+    static constexpr void CheckMode() {
+        static_assert(std::is_base_of_v<T, AccessMode>);
+    }
+
+    /* the nibbles of the bus pins in the CR register starting from crFirst */
+    static constexpr uint32_t CrMask(uint32_t crFirst) {
+        uint32_t mask = 0U;
+        for (uint32_t pin = firstPin; pin < firstPin + width; ++pin) {
+            if (pin >= crFirst && pin < crFirst + pinsPerCr) {
+                mask |= 0xFU << ((pin - crFirst) * 4U);
+            }
+        }
+        return mask;
+    }
+
+    template <typename Setup>
+    static constexpr uint32_t CrWord(uint32_t crFirst) {
+        return (Setup::Cr * 0x11111111U) & CrMask(crFirst);
+    }
+};
@@ -0,0 +1,158 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cycle_counter.hpp"
+
+/* Profiling on the DWT cycle counter
+ *
+ * The probes are compiled only if HWREG_PROFILING is defined. Otherwise
+ *   Probe and ScopedTimer are empty and every call is removed by the
+ *   compiler: no code, no RAM, no DWT access.
+ *
+ * A probe is identified by its tag type, its statistics are a static
+ *   variable of the probe. Record() is not atomic, so a probe must be used
+ *   by one context only (the main loop or one interrupt).
+ *
+ * Example:
+ *   using TogglePrb = Probe<struct LedToggleTag>;
+ *
+ *   Profiler::Init();
+ *   {
+ *       ScopedTimer<TogglePrb> timer;
+ *       Led::Toggle();
+ *   }
+ *   const auto stats = TogglePrb::Get();   // min, max, mean, histogram
+ */
+
+struct Profiler {
+#if defined(HWREG_PROFILING)
+    static constexpr bool IsEnabled = true;
+#else
+    static constexpr bool IsEnabled = false;
+#endif
+
+    /* Enables the counter and measures the cost of a measurement */
+    static void Init() {
+        if constexpr (IsEnabled) {
+            CycleCounter::Enable();
+
+            overhead = UINT32_MAX;
+            for (uint32_t i = 0; i < 8U; ++i) {
+                const uint32_t start = CycleCounter::Now();
+                const uint32_t cycles = CycleCounter::Since(start);
+                if (cycles < overhead) {
+                    overhead = cycles;
+                }
+            }
+        }
+    }
+
+    /* cycles of CycleCounter::Now() itself, subtracted by ScopedTimer */
+    static inline uint32_t overhead = 0U;
+};
+
+/* template for Probe class
+ *
+ * Tag  - any type, unique per probe
+ * bins - histogram size; bin 0 counts 0..1 cycles, bin n > 0 counts
+ *        [2^n, 2^(n+1)), the last bin counts everything above
+ */
+template <typename Tag, size_t bins = 16U>
+class Probe {
+public:
+    static_assert(bins > 0U && bins <= 32U, "There are 1..32 bins");
+
+    struct Stats {
+        uint32_t count;
+        uint32_t min;
+        uint32_t max;
+        uint64_t sum;
+        uint32_t histogram[bins];
+
+        constexpr uint32_t Mean() const {
+            return (count != 0U) ? static_cast<uint32_t>(sum / count) : 0U;
+        }
+    };
+
+    static inline void Record(uint32_t cycles) {
+        if constexpr (Profiler::IsEnabled) {
+            ++stats.count;
+            stats.sum += cycles;
+            if (cycles < stats.min) {
+                stats.min = cycles;
+            }
+            if (cycles > stats.max) {
+                stats.max = cycles;
+            }
+            ++stats.histogram[Bin(cycles)];
+        }
+    }
+
+    static Stats Get() {
+        return stats;
+    }
+
+    static void Reset() {
+        if constexpr (Profiler::IsEnabled) {
+            stats = Stats{0U, UINT32_MAX, 0U, 0U, {}};
+        }
+    }
+
+    static constexpr size_t Bin(uint32_t cycles) {
+        size_t bin = 0;
+        while (cycles > 1U && bin < bins - 1U) {
+            cycles >>= 1U;
+            ++bin;
+        }
+        return bin;
+    }
+
+private:
+    /* the disabled probe has no storage, Get() returns zeros */
+#if defined(HWREG_PROFILING)
+    static inline Stats stats = {0U, UINT32_MAX, 0U, 0U, {}};
+#else
+    static constexpr Stats stats = {0U, 0U, 0U, 0U, {}};
+#endif
+};
+
+/* template for ScopedTimer class
+ *
+ * Records the cycles from the construction to the end of the scope
+ *   into the probe.
+ *
+ * ProbeT - Probe
+ */
+template <typename ProbeT>
+class ScopedTimer {
+public:
+#if defined(HWREG_PROFILING)
+    ScopedTimer() : start(CycleCounter::Now())
+    {}
+
+    /* a scope below the calibrated overhead is 0, not a wrap-around */
+    ~ScopedTimer() {
+        const uint32_t cycles = CycleCounter::Since(start);
+        ProbeT::Record(cycles > Profiler::overhead ? cycles - Profiler::overhead : 0U);
+    }
+
+private:
+    const uint32_t start;
+
+public:
+#else
+    /* not trivial, so an unused timer is not a warning */
+    ScopedTimer()
+    {}
+
+    ~ScopedTimer()
+    {}
+#endif
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+};
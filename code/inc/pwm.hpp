@@ -0,0 +1,139 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+#include "sync.hpp"
+#include "pin.hpp"
+#include "timer.hpp"
+
+/* template for PwmTimer class
+ *
+ * The time base shared by the PWM channels of a timer: the period is
+ *   `steps` counts, and PSC is chosen at compile time so the frequency
+ *   matches. A frequency with more than 1% error is a compilation error.
+ *
+ * Timer    - TIM2, TIM3, TIM4
+ * Clock    - ClockConfig from clock.hpp
+ * freqHz   - PWM frequency
+ * steps    - duty resolution, the duty is 0..steps
+ */
+template <typename Timer, typename Clock, uint32_t freqHz, uint32_t steps>
+class PwmTimer {
+public:
+    using Regs = Timer;
+    using Map = TimerMap<Timer>;
+
+    static constexpr uint32_t Steps = steps;
+
+    static_assert(steps >= 2U && steps <= 0xFFFFU,
+                  "The resolution is 2..65535 steps");
+    static_assert(freqHz > 0U && freqHz <= Clock::TimClk1 / steps,
+                  "The frequency is too high for the resolution");
+
+    /* timer clock cycles per period */
+    static constexpr uint32_t Cycles = (Clock::TimClk1 + freqHz / 2U) / freqHz;
+    static constexpr uint32_t Psc = (Cycles + steps / 2U) / steps - 1U;
+    static constexpr uint32_t Arr = steps - 1U;
+    static constexpr uint32_t ActualCycles = (Psc + 1U) * steps;
+    static constexpr uint32_t ActualHz = Clock::TimClk1 / ActualCycles;
+
+    static_assert(Psc <= 0xFFFFU, "The frequency is too low for the resolution");
+    static_assert((ActualCycles > Cycles ? ActualCycles - Cycles :
+                                           Cycles - ActualCycles) * 100U <= Cycles,
+                  "The frequency error is more than 1%");
+
+    /* the counter runs, the channels are configured by PwmChannel */
+    static void Init() {
+        Map::ClockEnable::BitBand::Set();
+
+        Timer::CR1::Set(0U);
+        Timer::PSC::Set(Psc);
+        Timer::ARR::Set(Arr);
+        Timer::EGR::Set(Timer::EGR::UG);
+        Timer::SR::Set(0U);
+        Timer::CR1::Set(Timer::CR1::ARPE::Mask | Timer::CR1::CEN::Mask);
+    }
+};
+
+/* template for PwmChannel class
+ *
+ * A PWM output (mode 1) on a timer channel. CCR is preloaded: SetDuty() is
+ *   a single store, and the new duty starts with the next period, so a
+ *   period is never cut short or doubled.
+ *
+ * Base     - PwmTimer of the timer
+ * channel  - 1..4
+ * PinT     - the pin of the channel, checked against the timer pin map
+ *
+ * Example:
+ *   using Dimmer = PwmTimer<TIM2, SystemClock, 1'000, 1'000>;
+ *   using LedPwm = PwmChannel<Dimmer, 1, Led>;   // PA0
+ *   Dimmer::Init();
+ *   LedPwm::Init();
+ *   LedPwm::SetDuty(250);                         // 25%
+ */
+template <typename Base, uint32_t channel, typename PinT>
+class PwmChannel {
+    using Timer = typename Base::Regs;
+    using Ch = typename Timer::template Channel<channel>;
+    using MapPin = typename Base::Map::template ChannelPin<channel>;
+
+    static_assert(std::is_same_v<typename PinT::PortType, typename MapPin::PortType> &&
+                  PinT::Number == MapPin::Number,
+                  "The pin is not the output of the timer channel");
+    static_assert(std::is_base_of_v<PinMode::Config, typename PinT::Access>,
+                  "The pin must be configurable");
+
+public:
+    static constexpr uint32_t Steps = Base::Steps;
+
+    /* the duty of the percent, rounded down */
+    static constexpr uint32_t Percent(uint32_t percent) {
+        return Steps * percent / 100U;
+    }
+
+    /* Polarity - CCP value, ActiveLow inverts the output
+     * Sync     - concurrency policy of the CCMR/CCER/CRx updates; the timer
+     *            registers are 16-bit, out of reach of Exclusive
+     */
+    template <typename Polarity = typename Ch::CCP::ActiveHigh,
+              typename Sync = Utils::Sync::CriticalSection>
+    static void Init(uint32_t duty = 0U) {
+        /* the other channel of the CCMR may be in use */
+        Ch::template CCMRSet<
+            typename Ch::OCM::Pwm1,
+            typename Ch::OCPE::Enable,
+            typename Ch::CCS::Output
+        >::template Set<Sync>();
+        SetDuty(duty);
+        Timer::template CCERSet<Polarity, typename Ch::CCE::Enable>::template Set<Sync>();
+
+        PinT::template ConfigAlternate<Sync>();
+    }
+
+    /* 0 - always inactive, Steps - always active */
+    static inline void SetDuty(uint32_t duty) {
+        assert(duty <= Steps);
+
+        Ch::CCR::Set(static_cast<typename Ch::CCR::Type>(duty));
+    }
+
+    static inline uint32_t GetDuty() {
+        return Ch::CCR::Get();
+    }
+
+    /* the output is disconnected from the compare, the counter runs on */
+    static inline void Disable() {
+        Ch::CCE::BitBand::Reset();
+    }
+
+    static inline void Enable() {
+        Ch::CCE::BitBand::Set();
+    }
+};
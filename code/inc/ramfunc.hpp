@@ -0,0 +1,35 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+/* Code in SRAM
+ *
+ * At 72 MHz the flash has 2 wait states. The prefetch buffer hides them for
+ *   straight code, but every branch, and the entry of an interrupt, waits.
+ *   A function marked HWREG_RAMFUNC is linked into the .ramfunc section,
+ *   copied to SRAM by Reset_Handler, and runs with no wait states and the
+ *   same timing on every call.
+ *
+ * The inline calls of the function (Pin, Register, FieldValue...) are
+ *   compiled into it and run from SRAM too. A call of a function that is not
+ *   inlined (-Og inlines little) goes back to the flash.
+ *
+ * long_call: SRAM is out of the BL range of the flash, the calls of the
+ *   function load its address into a register.
+ *
+ * The vector table is copied to SRAM by Reset_Handler as well and VTOR points
+ *   to the copy, see STM32F103C8Tx_FLASH.ld. The vector fetch then shares
+ *   the system bus with the stacking instead of the wait states, check an
+ *   ISR latency with the profiler probes (profiler.hpp).
+ *
+ * Example:
+ *   HWREG_RAMFUNC static void ButtonIsr() {
+ *       Button::ClearInterrupt();
+ *       Led::Toggle();
+ *   }
+ */
+#if defined(__arm__)
+#define HWREG_RAMFUNC __attribute__((section(".ramfunc"), long_call, noinline))
+#else
+#define HWREG_RAMFUNC
+#endif
@@ -8,6 +8,9 @@
 #include <initializer_list>
 #include <limits>
 
+#include "bus.hpp"
+#include "sync.hpp"
+
 /* Access modes for registers */
 struct RegisterMode {
     /* No access (you cannot call methods, but you can read public fields) */
@@ -30,11 +33,45 @@ struct RegisterMode {
     {};
 };
 
+/* Write semantics of registers, as modifiedWriteValues in the SVD file */
+struct RegisterWrite {
+    /* Plain register:
+    * Written bits are kept, a field is written with read-modify-write
+    */
+    struct Modify
+    {};
+    /* Write-only:
+    * Zero bits have no effect and the register reads as 0 (BSRR, BRR)
+    */
+    struct WriteOnly
+    {};
+    /* One to set:
+    * Writing 1 sets the bit, writing 0 has no effect
+    */
+    struct OneToSet
+    {};
+    /* One to clear:
+    * Writing 1 clears the bit, writing 0 has no effect (status flags)
+    */
+    struct OneToClear
+    {};
+    /* Zero to clear:
+    * Writing 0 clears the bit, writing 1 has no effect (rc_w0 status flags)
+    */
+    struct ZeroToClear
+    {};
+};
+
 /* Type of the register depends on its size */
 template <uint32_t size>
 struct RegisterDataType
 {};
 
+template <>
+struct RegisterDataType<8> {
+    using Type = uint8_t;
+};
+
 template <>
 struct RegisterDataType<16> {
     using Type = uint16_t;
@@ -53,30 +90,74 @@ struct RegisterDataType<32> {
  * address      - address of the hardware resigter
  * size         - size, bits
  * AccessMode   - mode, declared above
+ * Semantics    - RegisterWrite semantics, declared above
+ * BusPolicy    - how the register is accessed, see bus.hpp
  */
-template <uintptr_t address, size_t size, typename AccessMode>
+template <uintptr_t address, size_t size, typename AccessMode,
+          typename Semantics = RegisterWrite::Modify,
+          typename BusPolicy = DefaultBus>
 class Register {
 public:
     /* declared here to be available outside */
     static constexpr uintptr_t Address = address;
     using Type = typename RegisterDataType<size>::Type;
+    using Access = AccessMode;
+    using WriteSemantics = Semantics;
+    using Bus = BusPolicy;
+    static constexpr bool IsStoreOnly =
+        !std::is_same_v<Semantics, RegisterWrite::Modify>;
 
     inline static Type Get() {
         CheckMode<RegisterMode::Read>();
 
-        return *reinterpret_cast<Type *>(address);
+        return Bus::template Load<Type>(address);
     }
 
     inline static void Set(Type value) {
         CheckMode<RegisterMode::Write>();
 
-        *reinterpret_cast<Type *>(address) = value;
+        Bus::template Store<Type>(address, value);
     }
 
     inline static void Toggle(Type value) {
         CheckMode<RegisterMode::Write>();
+        static_assert(!IsStoreOnly, "The register cannot be toggled");
+
+        Bus::template Store<Type>(address,
+                                  Bus::template Load<Type>(address) ^ value);
+    }
+
+    /* Write the bits under the mask, keep the others. The value must be
+     *   within the mask (see sync.hpp), RegisterField::Set masks its own.
+     *
+     * Plain registers get a read-modify-write (or a single store if the mask
+     *   covers the whole register). Write-only, one-to-set and one-to-clear
+     *   registers get a single store of the selected bits, no read at all.
+     *   Zero-to-clear registers get a single store with ones out of the mask,
+     *   a flag raised by the hardware meanwhile is not written back as 0.
+     *
+     * Sync - concurrency policy of the read-modify-write, see sync.hpp
+     */
+    template <typename Sync = Utils::Sync::None>
+    inline static void SetMasked(Type mask, Type value) {
+        CheckMode<RegisterMode::Write>();
 
-        *reinterpret_cast<Type *>(address) ^= value ;
+        if constexpr (std::is_same_v<Semantics, RegisterWrite::ZeroToClear>) {
+            Bus::template Store<Type>(address, static_cast<Type>(value | ~mask));
+        } else if constexpr (IsStoreOnly) {
+            Bus::template Store<Type>(address, value & mask);
+        } else {
+            if constexpr (std::is_same_v<Sync, Utils::Sync::BitBand>) {
+                static_assert(BitBandAlias::IsInRegion(address),
+                              "The register is out of the bit-band regions");
+            }
+
+            if (mask == std::numeric_limits<Type>::max()) {
+                Bus::template Store<Type>(address, value);
+            } else {
+                Sync::template Modify<Type, Bus>(address, mask, value);
+            }
+        }
     }
 
 private:
@@ -87,6 +168,58 @@ private:
     }
 };
 
+/* BitBandField
+ *
+ * Single-bit access through the bit-band alias: Set, Reset and Write are one
+ *   store, Get is one load. No read-modify-write, no retry loop, no need to
+ *   mask interrupts. Use it as RegisterField::BitBand.
+ *
+ * Reg          - register
+ * offset       - offset of the bit
+ * size         - size of the field, must be 1
+ * AccessMode   - RegisterMode mode, declared above
+ */
+template <typename Reg, size_t offset, size_t size, typename AccessMode>
+class BitBandField {
+public:
+    static constexpr uintptr_t Address = BitBandAlias::Address(Reg::Address,
+                                                               offset);
+    using Bus = typename Reg::Bus;
+
+    inline static uint32_t Get() {
+        CheckMode<RegisterMode::Read>();
+
+        return Bus::template Load<uint32_t>(Address);
+    }
+
+    inline static void Write(uint32_t value) {
+        CheckMode<RegisterMode::Write>();
+
+        Bus::template Store<uint32_t>(Address, value & 1U);
+    }
+
+    inline static void Set() {
+        Write(1U);
+    }
+
+    inline static void Reset() {
+        Write(0U);
+    }
+
+private:
+    /* Check the mode, instead of SFINAE */
+    template <typename T>
+    static inline constexpr void CheckMode() {
+        static_assert(size == 1U, "Bit-band works for 1-bit fields only");
+        static_assert(BitBandAlias::IsInRegion(Reg::Address),
+                      "The register is out of the bit-band regions");
+        /* the bit-band write is a read-modify-write of the whole word */
+        static_assert(!Reg::IsStoreOnly,
+                      "Bit-band cannot be used with this write semantics");
+        static_assert(std::is_base_of_v<T, AccessMode>);
+    }
+};
+
 /* RegisterField
  *
  * For example, GPIOA->ODR[0] is a register field
@@ -102,6 +235,7 @@ public:
     /* declared here to be visible outside */
     using RegType = typename Reg::Type;
     using Register = Reg;
+    using Bus = typename Reg::Bus;
     static constexpr RegType Offset = offset;
     static constexpr RegType Size = size;
     static constexpr RegType Mask = (size < sizeof(RegType) * 8U) ?
@@ -109,21 +243,21 @@ public:
                                     std::numeric_limits<RegType>::max();
 
     using Access = AccessMode;
+    /* single-bit fields only, see BitBandField */
+    using BitBand = BitBandField<Reg, offset, size, AccessMode>;
 
     inline static RegType Get() {
         CheckMode<RegisterMode::Read>();
 
-        return ((*reinterpret_cast<RegType *>(Reg::Address)) & Mask) >> offset;
+        return (Bus::template Load<RegType>(Reg::Address) & Mask) >> offset;
     }
 
+    template <typename Sync = Utils::Sync::None>
     static void Set(RegType value) {
         CheckMode<RegisterMode::Write>();
 
-        RegType newValue = *reinterpret_cast<RegType *>(Reg::Address);
-        newValue &= ~Mask;
-        newValue |= (value << offset);
-
-        *reinterpret_cast<RegType *>(Reg::Address) = newValue;
+        Reg::template SetMasked<Sync>(Mask,
+                                      static_cast<RegType>((value << offset) & Mask));
     }
 
 private:
@@ -147,26 +281,25 @@ struct FieldValue {
     using Type = typename Field::Register::Type;
     using BaseType = Base;
     using Access = typename Field::Access;
+    using Register = typename Field::Register;
+    using Bus = typename Field::Register::Bus;
     constexpr static Type Mask = static_cast<Type>(1U << Field::Size) - 1U;
     constexpr static Type Value = value;
     constexpr static Type Offset = Field::Offset;
 
+    template <typename Sync = Utils::Sync::None>
     static void Set() {
         CheckMode<RegisterMode::Write>();
 
-        Type newRegValue;
-        newRegValue = *reinterpret_cast<Type *>(Field::Register::Address);
-        newRegValue &= ~Mask;
-        newRegValue |= (value << Field::Offset);
-
-        *reinterpret_cast<Type *>(Field::Register::Address) = newRegValue;
+        Field::Register::template SetMasked<Sync>(Mask << Field::Offset,
+                                                  value << Field::Offset);
     }
 
     inline static bool IsSet() {
         CheckMode<RegisterMode::Read>();
 
-        Type regValue = *reinterpret_cast<Type*>(Field::Register::Address);
-        return (regValue & Mask) == (value << Field::Offset);
+        Type regValue = Bus::template Load<Type>(Field::Register::Address);
+        return (regValue & (Mask << Field::Offset)) == (value << Field::Offset);
     }
 
 private:
@@ -182,38 +315,33 @@ private:
  * An alternative way for working with a hardware resiter.
  * Allows you to set sevetal RegisterField values simultaneously.
  *
- * address            - address of the hardware resigter
- * size               - size, bits
- * AccessMode         - mode, declared above
+ * Reg                - register
  * FieldValueBaseType - base type
  * Args               - FieldValues
  */
-template <uint32_t address, size_t size, typename AccessMode,
-          typename FieldValueBaseType, typename... Args>
+template <typename Reg, typename FieldValueBaseType, typename... Args>
 class RegisterFieldSet {
 public:
-    using Type = typename RegisterDataType<size>::Type;
+    using Type = typename Reg::Type;
 
+    template <typename Sync = Utils::Sync::None>
     static void Set() {
         CheckMode<RegisterMode::Write>();
 
-        Type regValue = *reinterpret_cast<Type *>(address);
-        regValue &= ~GetMask();
-        regValue |= GetValue();
-        *reinterpret_cast<Type *>(address) = regValue;
+        Reg::template SetMasked<Sync>(GetMask(), GetValue());
     }
 
     static bool IsSet() {
         CheckMode<RegisterMode::Read>();
 
-        Type regValue = *reinterpret_cast<Type *>(address);
+        Type regValue = Reg::Bus::template Load<Type>(Reg::Address);
         return ((regValue & GetMask()) == GetValue());
     }
 
 private:
     template <typename T>
     static inline constexpr void CheckMode() {
-        static_assert(std::is_base_of_v<T, AccessMode>);
+        static_assert(std::is_base_of_v<T, typename Reg::Access>);
     }
 
 private:
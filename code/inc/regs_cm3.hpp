@@ -0,0 +1,173 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include "register.hpp"
+
+
+/* Description of the Cortex-M3 core peripherals
+ *
+ * Created manually using the ARMv7-M Architecture Reference Manual.
+ * Only the registers used by the project are described.
+ *
+ */
+
+
+/* * * * * * * *
+ *  Common
+ * * * * * * * */
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct CM3_Enable_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Disable = FieldValue<CM3_Enable_Values, BaseType, 0U>;
+    using Enable  = FieldValue<CM3_Enable_Values, BaseType, 1U>;
+};
+
+/* * * * * * * *
+ *  CoreDebug
+ * * * * * * * */
+
+struct CoreDebug {
+private:
+    static constexpr uintptr_t base = 0xE000EDF0U;
+    struct CoreDebugDEMCRBase {};
+
+public:
+    /* Debug Exception and Monitor Control Register */
+    struct DEMCR : public Register<base + 0x0C, 32U, RegisterMode::RW> {
+        /* Trace enable, required by DWT */
+        using TRCENA =
+            CM3_Enable_Values<CoreDebug::DEMCR, 24, RegisterMode::RW, CoreDebugDEMCRBase>;
+    };
+};
+
+/* * * * * * * *
+ *  DWT
+ * * * * * * * */
+
+struct DWT {
+private:
+    static constexpr uintptr_t base = 0xE0001000U;
+    struct DWTCTRLBase {};
+
+public:
+    /* Control register */
+    struct CTRL : public Register<base + 0x00, 32U, RegisterMode::RW> {
+        using CYCCNTENA =
+            CM3_Enable_Values<DWT::CTRL, 0, RegisterMode::RW, DWTCTRLBase>;
+    };
+
+    /* Cycle count register */
+    struct CYCCNT : public Register<base + 0x04, 32U, RegisterMode::RW>
+    {};
+};
+
+/* * * * * * * *
+ *  SysTick
+ * * * * * * * */
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct SysTick_CLKSOURCE_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using AhbDiv8 = FieldValue<SysTick_CLKSOURCE_Values, BaseType, 0U>;
+    using Core    = FieldValue<SysTick_CLKSOURCE_Values, BaseType, 1U>;
+};
+
+struct SysTick {
+private:
+    static constexpr uintptr_t base = 0xE000E010U;
+    struct SysTickCTRLBase {};
+
+public:
+    /* Control and status register, COUNTFLAG is cleared by a read */
+    struct CTRL : public Register<base + 0x00, 32U, RegisterMode::RW> {
+        using COUNTFLAG =
+            CM3_Enable_Values<SysTick::CTRL, 16, RegisterMode::Read, SysTickCTRLBase>;
+        using CLKSOURCE =
+            SysTick_CLKSOURCE_Values<SysTick::CTRL, 2, RegisterMode::RW, SysTickCTRLBase>;
+        using TICKINT =
+            CM3_Enable_Values<SysTick::CTRL, 1, RegisterMode::RW, SysTickCTRLBase>;
+        using ENABLE =
+            CM3_Enable_Values<SysTick::CTRL, 0, RegisterMode::RW, SysTickCTRLBase>;
+    };
+
+    /* Reload value register, 24 bits */
+    struct LOAD : public Register<base + 0x04, 32U, RegisterMode::RW> {
+        static constexpr uint32_t Max = 0x00FFFFFFU;
+    };
+
+    /* Current value register, any write clears it */
+    struct VAL : public Register<base + 0x08, 32U, RegisterMode::RW>
+    {};
+
+    /* Calibration value register */
+    struct CALIB : public Register<base + 0x0C, 32U, RegisterMode::Read>
+    {};
+};
+
+/* * * * * * * *
+ *  NVIC
+ * * * * * * * */
+
+struct NVIC {
+private:
+    static constexpr uintptr_t base = 0xE000E100U;
+
+public:
+    /* Interrupt set-enable registers */
+    template <uint32_t n>
+    struct ISER : public Register<base + 0x000 + n * 4U, 32U, RegisterMode::RW,
+                                  RegisterWrite::OneToSet>
+    {};
+
+    /* Interrupt clear-enable registers */
+    template <uint32_t n>
+    struct ICER : public Register<base + 0x080 + n * 4U, 32U, RegisterMode::RW,
+                                  RegisterWrite::OneToClear>
+    {};
+
+    /* Interrupt set-pending registers */
+    template <uint32_t n>
+    struct ISPR : public Register<base + 0x100 + n * 4U, 32U, RegisterMode::RW,
+                                  RegisterWrite::OneToSet>
+    {};
+
+    /* Interrupt clear-pending registers */
+    template <uint32_t n>
+    struct ICPR : public Register<base + 0x180 + n * 4U, 32U, RegisterMode::RW,
+                                  RegisterWrite::OneToClear>
+    {};
+
+    /* Interrupt priority registers, byte-accessible */
+    template <uint32_t n>
+    struct IPR : public Register<base + 0x300 + n, 8U, RegisterMode::RW>
+    {};
+};
+
+/* * * * * * * *
+ *  SCB
+ * * * * * * * */
+
+struct SCB {
+private:
+    static constexpr uintptr_t base = 0xE000ED00U;
+
+public:
+    /* Vector table offset register */
+    struct VTOR : public Register<base + 0x08, 32U, RegisterMode::RW>
+    {};
+
+    /* Application interrupt and reset control register */
+    struct AIRCR : public Register<base + 0x0C, 32U, RegisterMode::RW> {
+        static constexpr uint32_t VectKey = 0x05FAU << 16U;
+        static constexpr uint32_t PriGroupOffset = 8U;
+    };
+
+    /* System control register */
+    struct SCR : public Register<base + 0x10, 32U, RegisterMode::RW>
+    {};
+
+    /* System handler priority registers, byte-accessible, handlers 4..15 */
+    template <uint32_t n>
+    struct SHPR : public Register<base + 0x18 + n - 4U, 8U, RegisterMode::RW>
+    {};
+};
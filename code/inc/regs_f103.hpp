@@ -8,9 +8,12 @@
 /* Description of peripheral registers for STM32F103
  *
  * The existing fields were created manually using the attached SVD file
- *   for PoC purporses.
+ *   for PoC purporses, with the named values the drivers use.
  *
- * If it is required to add all the registers you can make a simple script.
+ * The whole device is generated from the SVD by tools/svd2hpp.py into
+ *   <build>/gen/svd/, namespace svd (target svd_headers). Those are plain
+ *   fields without named values; bench/host/svd_budget.cpp checks the
+ *   fields here against them.
  *
  */
 
@@ -25,13 +28,156 @@ struct RCC_APB2ENR_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
     using Enable = FieldValue<RCC_APB2ENR_Values, BaseType, 1U>;
 };
 
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct RCC_APB1ENR_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Disable = FieldValue<RCC_APB1ENR_Values, BaseType, 0U>;
+    using Enable = FieldValue<RCC_APB1ENR_Values, BaseType, 1U>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct RCC_AHBENR_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Disable = FieldValue<RCC_AHBENR_Values, BaseType, 0U>;
+    using Enable = FieldValue<RCC_AHBENR_Values, BaseType, 1U>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct RCC_OnOff_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Off = FieldValue<RCC_OnOff_Values, BaseType, 0U>;
+    using On  = FieldValue<RCC_OnOff_Values, BaseType, 1U>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct RCC_Ready_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using NotReady = FieldValue<RCC_Ready_Values, BaseType, 0U>;
+    using Ready    = FieldValue<RCC_Ready_Values, BaseType, 1U>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct RCC_CFGR_SW_Values : public RegisterField<Reg, offset, 2U, AccessMode> {
+    using HSI = FieldValue<RCC_CFGR_SW_Values, BaseType, 0b00>;
+    using HSE = FieldValue<RCC_CFGR_SW_Values, BaseType, 0b01>;
+    using PLL = FieldValue<RCC_CFGR_SW_Values, BaseType, 0b10>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct RCC_CFGR_HPRE_Values : public RegisterField<Reg, offset, 4U, AccessMode> {
+    using Div1   = FieldValue<RCC_CFGR_HPRE_Values, BaseType, 0b0000>;
+    using Div2   = FieldValue<RCC_CFGR_HPRE_Values, BaseType, 0b1000>;
+    using Div4   = FieldValue<RCC_CFGR_HPRE_Values, BaseType, 0b1001>;
+    using Div8   = FieldValue<RCC_CFGR_HPRE_Values, BaseType, 0b1010>;
+    using Div16  = FieldValue<RCC_CFGR_HPRE_Values, BaseType, 0b1011>;
+    using Div64  = FieldValue<RCC_CFGR_HPRE_Values, BaseType, 0b1100>;
+    using Div128 = FieldValue<RCC_CFGR_HPRE_Values, BaseType, 0b1101>;
+    using Div256 = FieldValue<RCC_CFGR_HPRE_Values, BaseType, 0b1110>;
+    using Div512 = FieldValue<RCC_CFGR_HPRE_Values, BaseType, 0b1111>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct RCC_CFGR_PPRE_Values : public RegisterField<Reg, offset, 3U, AccessMode> {
+    using Div1  = FieldValue<RCC_CFGR_PPRE_Values, BaseType, 0b000>;
+    using Div2  = FieldValue<RCC_CFGR_PPRE_Values, BaseType, 0b100>;
+    using Div4  = FieldValue<RCC_CFGR_PPRE_Values, BaseType, 0b101>;
+    using Div8  = FieldValue<RCC_CFGR_PPRE_Values, BaseType, 0b110>;
+    using Div16 = FieldValue<RCC_CFGR_PPRE_Values, BaseType, 0b111>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct RCC_CFGR_ADCPRE_Values : public RegisterField<Reg, offset, 2U, AccessMode> {
+    using Div2 = FieldValue<RCC_CFGR_ADCPRE_Values, BaseType, 0b00>;
+    using Div4 = FieldValue<RCC_CFGR_ADCPRE_Values, BaseType, 0b01>;
+    using Div6 = FieldValue<RCC_CFGR_ADCPRE_Values, BaseType, 0b10>;
+    using Div8 = FieldValue<RCC_CFGR_ADCPRE_Values, BaseType, 0b11>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct RCC_CFGR_PLLSRC_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using HSIDiv2 = FieldValue<RCC_CFGR_PLLSRC_Values, BaseType, 0U>;
+    using HSE     = FieldValue<RCC_CFGR_PLLSRC_Values, BaseType, 1U>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct RCC_CFGR_PLLXTPRE_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Div1 = FieldValue<RCC_CFGR_PLLXTPRE_Values, BaseType, 0U>;
+    using Div2 = FieldValue<RCC_CFGR_PLLXTPRE_Values, BaseType, 1U>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct RCC_CFGR_PLLMUL_Values : public RegisterField<Reg, offset, 4U, AccessMode> {
+    /* x2 .. x16 */
+    template <uint32_t mul>
+    using Mul = FieldValue<RCC_CFGR_PLLMUL_Values, BaseType, mul - 2U>;
+};
+
 struct RCC {
 private:
     static constexpr uintptr_t base = 0x40021000U;
     struct RCCAPB2ENRBase {};
+    struct RCCAPB1ENRBase {};
+    struct RCCAHBENRBase {};
+    struct RCCCRBase {};
+    struct RCCCFGRBase {};
 
 public:
+    /* Clock control register */
+    struct CR : public Register<base + 0x00, 32U, RegisterMode::RW> {
+        using PLLRDY =
+            RCC_Ready_Values<RCC::CR, 25, RegisterMode::Read, RCCCRBase>;
+        using PLLON =
+            RCC_OnOff_Values<RCC::CR, 24, RegisterMode::RW, RCCCRBase>;
+        using HSEBYP =
+            RCC_OnOff_Values<RCC::CR, 18, RegisterMode::RW, RCCCRBase>;
+        using HSERDY =
+            RCC_Ready_Values<RCC::CR, 17, RegisterMode::Read, RCCCRBase>;
+        using HSEON =
+            RCC_OnOff_Values<RCC::CR, 16, RegisterMode::RW, RCCCRBase>;
+        using HSIRDY =
+            RCC_Ready_Values<RCC::CR, 1,  RegisterMode::Read, RCCCRBase>;
+        using HSION =
+            RCC_OnOff_Values<RCC::CR, 0,  RegisterMode::RW, RCCCRBase>;
+    };
+
+    /* Clock configuration register */
+    struct CFGR : public Register<base + 0x04, 32U, RegisterMode::RW> {
+        using PLLMUL =
+            RCC_CFGR_PLLMUL_Values<RCC::CFGR, 18, RegisterMode::RW, RCCCFGRBase>;
+        using PLLXTPRE =
+            RCC_CFGR_PLLXTPRE_Values<RCC::CFGR, 17, RegisterMode::RW, RCCCFGRBase>;
+        using PLLSRC =
+            RCC_CFGR_PLLSRC_Values<RCC::CFGR, 16, RegisterMode::RW, RCCCFGRBase>;
+        using ADCPRE =
+            RCC_CFGR_ADCPRE_Values<RCC::CFGR, 14, RegisterMode::RW, RCCCFGRBase>;
+        using PPRE2 =
+            RCC_CFGR_PPRE_Values<RCC::CFGR, 11, RegisterMode::RW, RCCCFGRBase>;
+        using PPRE1 =
+            RCC_CFGR_PPRE_Values<RCC::CFGR, 8,  RegisterMode::RW, RCCCFGRBase>;
+        using HPRE =
+            RCC_CFGR_HPRE_Values<RCC::CFGR, 4,  RegisterMode::RW, RCCCFGRBase>;
+        using SWS =
+            RCC_CFGR_SW_Values<RCC::CFGR, 2,  RegisterMode::Read, RCCCFGRBase>;
+        using SW =
+            RCC_CFGR_SW_Values<RCC::CFGR, 0,  RegisterMode::RW, RCCCFGRBase>;
+    };
+    template <typename... T>
+    using CFGRSet = RegisterFieldSet<CFGR, RCCCFGRBase, T...>;
+
+    /* AHB peripheral clock enable register */
+    struct AHBENR : public Register<base + 0x14, 32U,  RegisterMode::RW> {
+        /* ... */
+        using DMA1EN =
+            RCC_AHBENR_Values<RCC::AHBENR, 0,  RegisterMode::RW, RCCAHBENRBase>;
+    };
+    template <typename... T>
+    using AHBENRSet =
+        RegisterFieldSet<AHBENR, RCCAHBENRBase, T...>;
+
     struct APB2ENR : public Register<base + 0x18, 32U,  RegisterMode::RW> {
+        using USART1EN =
+            RCC_APB2ENR_Values<RCC::APB2ENR, 14, RegisterMode::RW, RCCAPB2ENRBase>;
+        /* ... */
+        using ADC2EN =
+            RCC_APB2ENR_Values<RCC::APB2ENR, 10, RegisterMode::RW, RCCAPB2ENRBase>;
+        using ADC1EN =
+            RCC_APB2ENR_Values<RCC::APB2ENR, 9,  RegisterMode::RW, RCCAPB2ENRBase>;
         /* ... */
         using GPIOCEN =
             RCC_APB2ENR_Values<RCC::APB2ENR, 4,  RegisterMode::RW, RCCAPB2ENRBase>;
@@ -47,7 +193,809 @@ public:
     };
     template <typename... T>
     using APB2ENRSet =
-        RegisterFieldSet<base + 0x18, 32U,  RegisterMode::RW, RCCAPB2ENRBase, T...>;
+        RegisterFieldSet<APB2ENR, RCCAPB2ENRBase, T...>;
+
+    /* APB1 peripheral clock enable register */
+    struct APB1ENR : public Register<base + 0x1C, 32U,  RegisterMode::RW> {
+        /* ... */
+        using USART3EN =
+            RCC_APB1ENR_Values<RCC::APB1ENR, 18, RegisterMode::RW, RCCAPB1ENRBase>;
+        using USART2EN =
+            RCC_APB1ENR_Values<RCC::APB1ENR, 17, RegisterMode::RW, RCCAPB1ENRBase>;
+        /* ... */
+        using TIM4EN =
+            RCC_APB1ENR_Values<RCC::APB1ENR, 2,  RegisterMode::RW, RCCAPB1ENRBase>;
+        using TIM3EN =
+            RCC_APB1ENR_Values<RCC::APB1ENR, 1,  RegisterMode::RW, RCCAPB1ENRBase>;
+        using TIM2EN =
+            RCC_APB1ENR_Values<RCC::APB1ENR, 0,  RegisterMode::RW, RCCAPB1ENRBase>;
+    };
+    template <typename... T>
+    using APB1ENRSet =
+        RegisterFieldSet<APB1ENR, RCCAPB1ENRBase, T...>;
+};
+
+/* * * * * * * *
+ *  FLASH
+ * * * * * * * */
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct FLASH_ACR_LATENCY_Values : public RegisterField<Reg, offset, 3U, AccessMode> {
+    using WS0 = FieldValue<FLASH_ACR_LATENCY_Values, BaseType, 0b000>;
+    using WS1 = FieldValue<FLASH_ACR_LATENCY_Values, BaseType, 0b001>;
+    using WS2 = FieldValue<FLASH_ACR_LATENCY_Values, BaseType, 0b010>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct FLASH_ACR_Enable_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Disable = FieldValue<FLASH_ACR_Enable_Values, BaseType, 0U>;
+    using Enable  = FieldValue<FLASH_ACR_Enable_Values, BaseType, 1U>;
+};
+
+struct FLASH {
+private:
+    static constexpr uintptr_t base = 0x40022000U;
+    struct FLASHACRBase {};
+
+public:
+    /* Flash access control register */
+    struct ACR : public Register<base + 0x00, 32U, RegisterMode::RW> {
+        using PRFTBS =
+            FLASH_ACR_Enable_Values<FLASH::ACR, 5, RegisterMode::Read, FLASHACRBase>;
+        using PRFTBE =
+            FLASH_ACR_Enable_Values<FLASH::ACR, 4, RegisterMode::RW, FLASHACRBase>;
+        using HLFCYA =
+            FLASH_ACR_Enable_Values<FLASH::ACR, 3, RegisterMode::RW, FLASHACRBase>;
+        using LATENCY =
+            FLASH_ACR_LATENCY_Values<FLASH::ACR, 0, RegisterMode::RW, FLASHACRBase>;
+    };
+    template <typename... T>
+    using ACRSet = RegisterFieldSet<ACR, FLASHACRBase, T...>;
+};
+
+/* * * * * * * *
+ *  DMA
+ * * * * * * * */
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct DMA_CCR_Enable_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Disable = FieldValue<DMA_CCR_Enable_Values, BaseType, 0U>;
+    using Enable  = FieldValue<DMA_CCR_Enable_Values, BaseType, 1U>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct DMA_CCR_DIR_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using FromPeripheral = FieldValue<DMA_CCR_DIR_Values, BaseType, 0U>;
+    using FromMemory     = FieldValue<DMA_CCR_DIR_Values, BaseType, 1U>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct DMA_CCR_SIZE_Values : public RegisterField<Reg, offset, 2U, AccessMode> {
+    using Bits8  = FieldValue<DMA_CCR_SIZE_Values, BaseType, 0b00>;
+    using Bits16 = FieldValue<DMA_CCR_SIZE_Values, BaseType, 0b01>;
+    using Bits32 = FieldValue<DMA_CCR_SIZE_Values, BaseType, 0b10>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct DMA_CCR_PL_Values : public RegisterField<Reg, offset, 2U, AccessMode> {
+    using Low      = FieldValue<DMA_CCR_PL_Values, BaseType, 0b00>;
+    using Medium   = FieldValue<DMA_CCR_PL_Values, BaseType, 0b01>;
+    using High     = FieldValue<DMA_CCR_PL_Values, BaseType, 0b10>;
+    using VeryHigh = FieldValue<DMA_CCR_PL_Values, BaseType, 0b11>;
+};
+
+template <uintptr_t addr>
+struct DMA {
+    /* Flags of the channel n (1..7) in ISR and IFCR */
+    template <uint32_t n>
+    struct Flags {
+        static_assert(n >= 1U && n <= 7U, "DMA1 has channels 1..7");
+        static constexpr uint32_t GIF  = 1U << ((n - 1U) * 4U);
+        static constexpr uint32_t TCIF = 2U << ((n - 1U) * 4U);
+        static constexpr uint32_t HTIF = 4U << ((n - 1U) * 4U);
+        static constexpr uint32_t TEIF = 8U << ((n - 1U) * 4U);
+    };
+
+    /* Interrupt status register */
+    struct ISR : public Register<addr + 0x00, 32U, RegisterMode::Read>
+    {};
+
+    /* Interrupt flag clear register, a flag is cleared by writing 1 */
+    struct IFCR : public Register<addr + 0x04, 32U, RegisterMode::Write,
+                                  RegisterWrite::OneToClear>
+    {};
+
+    /* Channel n (1..7) */
+    template <uint32_t n>
+    struct Channel {
+    private:
+        static constexpr uintptr_t base = addr + 0x08 + (n - 1U) * 20U;
+        struct DMACCRBase {};
+
+    public:
+        /* Configuration register */
+        struct CCR : public Register<base + 0x00, 32U, RegisterMode::RW> {
+            using MEM2MEM =
+                DMA_CCR_Enable_Values<Channel::CCR, 14, RegisterMode::RW, DMACCRBase>;
+            using PL =
+                DMA_CCR_PL_Values<Channel::CCR, 12, RegisterMode::RW, DMACCRBase>;
+            using MSIZE =
+                DMA_CCR_SIZE_Values<Channel::CCR, 10, RegisterMode::RW, DMACCRBase>;
+            using PSIZE =
+                DMA_CCR_SIZE_Values<Channel::CCR, 8,  RegisterMode::RW, DMACCRBase>;
+            using MINC =
+                DMA_CCR_Enable_Values<Channel::CCR, 7,  RegisterMode::RW, DMACCRBase>;
+            using PINC =
+                DMA_CCR_Enable_Values<Channel::CCR, 6,  RegisterMode::RW, DMACCRBase>;
+            using CIRC =
+                DMA_CCR_Enable_Values<Channel::CCR, 5,  RegisterMode::RW, DMACCRBase>;
+            using DIR =
+                DMA_CCR_DIR_Values<Channel::CCR, 4,  RegisterMode::RW, DMACCRBase>;
+            using TEIE =
+                DMA_CCR_Enable_Values<Channel::CCR, 3,  RegisterMode::RW, DMACCRBase>;
+            using HTIE =
+                DMA_CCR_Enable_Values<Channel::CCR, 2,  RegisterMode::RW, DMACCRBase>;
+            using TCIE =
+                DMA_CCR_Enable_Values<Channel::CCR, 1,  RegisterMode::RW, DMACCRBase>;
+            using EN =
+                DMA_CCR_Enable_Values<Channel::CCR, 0,  RegisterMode::RW, DMACCRBase>;
+        };
+        template <typename... T>
+        using CCRSet = RegisterFieldSet<CCR, DMACCRBase, T...>;
+
+        /* Number of data register, 16 bits */
+        struct CNDTR : public Register<base + 0x04, 32U, RegisterMode::RW>
+        {};
+
+        /* Peripheral address register */
+        struct CPAR : public Register<base + 0x08, 32U, RegisterMode::RW>
+        {};
+
+        /* Memory address register */
+        struct CMAR : public Register<base + 0x0C, 32U, RegisterMode::RW>
+        {};
+    };
+};
+
+using DMA1 = DMA<0x40020000>;
+
+/* * * * * * * *
+ *  USART
+ * * * * * * * */
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct USART_Enable_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Disable = FieldValue<USART_Enable_Values, BaseType, 0U>;
+    using Enable  = FieldValue<USART_Enable_Values, BaseType, 1U>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct USART_SR_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Clear   = FieldValue<USART_SR_Values, BaseType, 0U>;
+    using Pending = FieldValue<USART_SR_Values, BaseType, 1U>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct USART_CR2_STOP_Values : public RegisterField<Reg, offset, 2U, AccessMode> {
+    using Stop1   = FieldValue<USART_CR2_STOP_Values, BaseType, 0b00>;
+    using Stop0_5 = FieldValue<USART_CR2_STOP_Values, BaseType, 0b01>;
+    using Stop2   = FieldValue<USART_CR2_STOP_Values, BaseType, 0b10>;
+    using Stop1_5 = FieldValue<USART_CR2_STOP_Values, BaseType, 0b11>;
+};
+
+template <uintptr_t addr>
+struct USART {
+private:
+    struct USARTSRBase  {};
+    struct USARTCR1Base {};
+    struct USARTCR2Base {};
+    struct USARTCR3Base {};
+
+public:
+    /* Status register, TC and RXNE are cleared by writing 0
+     *
+     * IDLE, ORE, NE, FE, PE are cleared by a read of SR followed by
+     *   a read of DR.
+     */
+    struct SR : public Register<addr + 0x00, 32U, RegisterMode::RW,
+                                RegisterWrite::ZeroToClear> {
+        using TXE =
+            USART_SR_Values<USART::SR, 7, RegisterMode::Read, USARTSRBase>;
+        using TC =
+            USART_SR_Values<USART::SR, 6, RegisterMode::RW, USARTSRBase>;
+        using RXNE =
+            USART_SR_Values<USART::SR, 5, RegisterMode::RW, USARTSRBase>;
+        using IDLE =
+            USART_SR_Values<USART::SR, 4, RegisterMode::Read, USARTSRBase>;
+        using ORE =
+            USART_SR_Values<USART::SR, 3, RegisterMode::Read, USARTSRBase>;
+        using NE =
+            USART_SR_Values<USART::SR, 2, RegisterMode::Read, USARTSRBase>;
+        using FE =
+            USART_SR_Values<USART::SR, 1, RegisterMode::Read, USARTSRBase>;
+        using PE =
+            USART_SR_Values<USART::SR, 0, RegisterMode::Read, USARTSRBase>;
+    };
+
+    /* Data register */
+    struct DR : public Register<addr + 0x04, 32U, RegisterMode::RW>
+    {};
+
+    /* Baud rate register, USARTDIV in 12.4 fixed point */
+    struct BRR : public Register<addr + 0x08, 32U, RegisterMode::RW> {
+        using DIV_Mantissa = RegisterField<USART::BRR, 4, 12U, RegisterMode::RW>;
+        using DIV_Fraction = RegisterField<USART::BRR, 0, 4U,  RegisterMode::RW>;
+    };
+
+    /* Control register 1 */
+    struct CR1 : public Register<addr + 0x0C, 32U, RegisterMode::RW> {
+        using UE =
+            USART_Enable_Values<USART::CR1, 13, RegisterMode::RW, USARTCR1Base>;
+        using M =
+            USART_Enable_Values<USART::CR1, 12, RegisterMode::RW, USARTCR1Base>;
+        using PCE =
+            USART_Enable_Values<USART::CR1, 10, RegisterMode::RW, USARTCR1Base>;
+        using PS =
+            USART_Enable_Values<USART::CR1, 9,  RegisterMode::RW, USARTCR1Base>;
+        using TXEIE =
+            USART_Enable_Values<USART::CR1, 7,  RegisterMode::RW, USARTCR1Base>;
+        using TCIE =
+            USART_Enable_Values<USART::CR1, 6,  RegisterMode::RW, USARTCR1Base>;
+        using RXNEIE =
+            USART_Enable_Values<USART::CR1, 5,  RegisterMode::RW, USARTCR1Base>;
+        using IDLEIE =
+            USART_Enable_Values<USART::CR1, 4,  RegisterMode::RW, USARTCR1Base>;
+        using TE =
+            USART_Enable_Values<USART::CR1, 3,  RegisterMode::RW, USARTCR1Base>;
+        using RE =
+            USART_Enable_Values<USART::CR1, 2,  RegisterMode::RW, USARTCR1Base>;
+    };
+    template <typename... T>
+    using CR1Set = RegisterFieldSet<CR1, USARTCR1Base, T...>;
+
+    /* Control register 2 */
+    struct CR2 : public Register<addr + 0x10, 32U, RegisterMode::RW> {
+        using STOP =
+            USART_CR2_STOP_Values<USART::CR2, 12, RegisterMode::RW, USARTCR2Base>;
+    };
+
+    /* Control register 3 */
+    struct CR3 : public Register<addr + 0x14, 32U, RegisterMode::RW> {
+        using DMAT =
+            USART_Enable_Values<USART::CR3, 7,  RegisterMode::RW, USARTCR3Base>;
+        using DMAR =
+            USART_Enable_Values<USART::CR3, 6,  RegisterMode::RW, USARTCR3Base>;
+        using EIE =
+            USART_Enable_Values<USART::CR3, 0,  RegisterMode::RW, USARTCR3Base>;
+    };
+    template <typename... T>
+    using CR3Set = RegisterFieldSet<CR3, USARTCR3Base, T...>;
+};
+
+using USART1 = USART<0x40013800>;
+using USART2 = USART<0x40004400>;
+using USART3 = USART<0x40004800>;
+
+/* * * * * * * *
+ *  TIM (general-purpose TIM2..TIM4)
+ * * * * * * * */
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct TIM_Enable_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Disable = FieldValue<TIM_Enable_Values, BaseType, 0U>;
+    using Enable  = FieldValue<TIM_Enable_Values, BaseType, 1U>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct TIM_SR_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Clear   = FieldValue<TIM_SR_Values, BaseType, 0U>;
+    using Pending = FieldValue<TIM_SR_Values, BaseType, 1U>;
+};
+
+/* Output compare mode */
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct TIM_OCM_Values : public RegisterField<Reg, offset, 3U, AccessMode> {
+    using Frozen          = FieldValue<TIM_OCM_Values, BaseType, 0b000>;
+    using ActiveOnMatch   = FieldValue<TIM_OCM_Values, BaseType, 0b001>;
+    using InactiveOnMatch = FieldValue<TIM_OCM_Values, BaseType, 0b010>;
+    using Toggle          = FieldValue<TIM_OCM_Values, BaseType, 0b011>;
+    using ForceInactive   = FieldValue<TIM_OCM_Values, BaseType, 0b100>;
+    using ForceActive     = FieldValue<TIM_OCM_Values, BaseType, 0b101>;
+    /* active while CNT < CCR */
+    using Pwm1            = FieldValue<TIM_OCM_Values, BaseType, 0b110>;
+    /* inactive while CNT < CCR */
+    using Pwm2            = FieldValue<TIM_OCM_Values, BaseType, 0b111>;
+};
+
+/* Capture/compare selection */
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct TIM_CCS_Values : public RegisterField<Reg, offset, 2U, AccessMode> {
+    using Output     = FieldValue<TIM_CCS_Values, BaseType, 0b00>;
+    using InputOwn   = FieldValue<TIM_CCS_Values, BaseType, 0b01>;
+    using InputPair  = FieldValue<TIM_CCS_Values, BaseType, 0b10>;
+    using InputTrc   = FieldValue<TIM_CCS_Values, BaseType, 0b11>;
+};
+
+/* Capture/compare output polarity */
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct TIM_CCP_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using ActiveHigh = FieldValue<TIM_CCP_Values, BaseType, 0U>;
+    using ActiveLow  = FieldValue<TIM_CCP_Values, BaseType, 1U>;
+};
+
+template <uintptr_t addr>
+struct TIM {
+private:
+    struct TIMCR1Base   {};
+    struct TIMDIERBase  {};
+    struct TIMSRBase    {};
+    struct TIMCCMR1Base {};
+    struct TIMCCMR2Base {};
+    struct TIMCCERBase  {};
+
+public:
+    /* Control register 1 */
+    struct CR1 : public Register<addr + 0x00, 16U, RegisterMode::RW> {
+        using ARPE =
+            TIM_Enable_Values<TIM::CR1, 7, RegisterMode::RW, TIMCR1Base>;
+        using OPM =
+            TIM_Enable_Values<TIM::CR1, 3, RegisterMode::RW, TIMCR1Base>;
+        using URS =
+            TIM_Enable_Values<TIM::CR1, 2, RegisterMode::RW, TIMCR1Base>;
+        using UDIS =
+            TIM_Enable_Values<TIM::CR1, 1, RegisterMode::RW, TIMCR1Base>;
+        using CEN =
+            TIM_Enable_Values<TIM::CR1, 0, RegisterMode::RW, TIMCR1Base>;
+    };
+    template <typename... T>
+    using CR1Set = RegisterFieldSet<CR1, TIMCR1Base, T...>;
+
+    /* DMA/interrupt enable register */
+    struct DIER : public Register<addr + 0x0C, 16U, RegisterMode::RW> {
+        /* ... */
+        using UDE =
+            TIM_Enable_Values<TIM::DIER, 8, RegisterMode::RW, TIMDIERBase>;
+        /* ... */
+        using UIE =
+            TIM_Enable_Values<TIM::DIER, 0, RegisterMode::RW, TIMDIERBase>;
+    };
+    template <typename... T>
+    using DIERSet = RegisterFieldSet<DIER, TIMDIERBase, T...>;
+
+    /* Status register, a flag is cleared by writing 0 */
+    struct SR : public Register<addr + 0x10, 16U, RegisterMode::RW,
+                                RegisterWrite::ZeroToClear> {
+        /* ... */
+        using UIF =
+            TIM_SR_Values<TIM::SR, 0, RegisterMode::RW, TIMSRBase>;
+    };
+
+    /* Event generation register */
+    struct EGR : public Register<addr + 0x14, 16U, RegisterMode::Write,
+                                 RegisterWrite::OneToSet> {
+        static constexpr uint16_t UG = 1U << 0U;
+    };
+
+    /* Capture/compare mode register 1, channels 1 and 2 (output mode) */
+    struct CCMR1 : public Register<addr + 0x18, 16U, RegisterMode::RW> {
+        using OC2M =
+            TIM_OCM_Values<TIM::CCMR1, 12, RegisterMode::RW, TIMCCMR1Base>;
+        using OC2PE =
+            TIM_Enable_Values<TIM::CCMR1, 11, RegisterMode::RW, TIMCCMR1Base>;
+        using OC2FE =
+            TIM_Enable_Values<TIM::CCMR1, 10, RegisterMode::RW, TIMCCMR1Base>;
+        using CC2S =
+            TIM_CCS_Values<TIM::CCMR1, 8, RegisterMode::RW, TIMCCMR1Base>;
+        using OC1M =
+            TIM_OCM_Values<TIM::CCMR1, 4, RegisterMode::RW, TIMCCMR1Base>;
+        using OC1PE =
+            TIM_Enable_Values<TIM::CCMR1, 3, RegisterMode::RW, TIMCCMR1Base>;
+        using OC1FE =
+            TIM_Enable_Values<TIM::CCMR1, 2, RegisterMode::RW, TIMCCMR1Base>;
+        using CC1S =
+            TIM_CCS_Values<TIM::CCMR1, 0, RegisterMode::RW, TIMCCMR1Base>;
+    };
+    template <typename... T>
+    using CCMR1Set = RegisterFieldSet<CCMR1, TIMCCMR1Base, T...>;
+
+    /* Capture/compare mode register 2, channels 3 and 4 (output mode) */
+    struct CCMR2 : public Register<addr + 0x1C, 16U, RegisterMode::RW> {
+        using OC4M =
+            TIM_OCM_Values<TIM::CCMR2, 12, RegisterMode::RW, TIMCCMR2Base>;
+        using OC4PE =
+            TIM_Enable_Values<TIM::CCMR2, 11, RegisterMode::RW, TIMCCMR2Base>;
+        using OC4FE =
+            TIM_Enable_Values<TIM::CCMR2, 10, RegisterMode::RW, TIMCCMR2Base>;
+        using CC4S =
+            TIM_CCS_Values<TIM::CCMR2, 8, RegisterMode::RW, TIMCCMR2Base>;
+        using OC3M =
+            TIM_OCM_Values<TIM::CCMR2, 4, RegisterMode::RW, TIMCCMR2Base>;
+        using OC3PE =
+            TIM_Enable_Values<TIM::CCMR2, 3, RegisterMode::RW, TIMCCMR2Base>;
+        using OC3FE =
+            TIM_Enable_Values<TIM::CCMR2, 2, RegisterMode::RW, TIMCCMR2Base>;
+        using CC3S =
+            TIM_CCS_Values<TIM::CCMR2, 0, RegisterMode::RW, TIMCCMR2Base>;
+    };
+    template <typename... T>
+    using CCMR2Set = RegisterFieldSet<CCMR2, TIMCCMR2Base, T...>;
+
+    /* Capture/compare enable register */
+    struct CCER : public Register<addr + 0x20, 16U, RegisterMode::RW> {
+        using CC4P =
+            TIM_CCP_Values<TIM::CCER, 13, RegisterMode::RW, TIMCCERBase>;
+        using CC4E =
+            TIM_Enable_Values<TIM::CCER, 12, RegisterMode::RW, TIMCCERBase>;
+        using CC3P =
+            TIM_CCP_Values<TIM::CCER, 9,  RegisterMode::RW, TIMCCERBase>;
+        using CC3E =
+            TIM_Enable_Values<TIM::CCER, 8,  RegisterMode::RW, TIMCCERBase>;
+        using CC2P =
+            TIM_CCP_Values<TIM::CCER, 5,  RegisterMode::RW, TIMCCERBase>;
+        using CC2E =
+            TIM_Enable_Values<TIM::CCER, 4,  RegisterMode::RW, TIMCCERBase>;
+        using CC1P =
+            TIM_CCP_Values<TIM::CCER, 1,  RegisterMode::RW, TIMCCERBase>;
+        using CC1E =
+            TIM_Enable_Values<TIM::CCER, 0,  RegisterMode::RW, TIMCCERBase>;
+    };
+    template <typename... T>
+    using CCERSet = RegisterFieldSet<CCER, TIMCCERBase, T...>;
+
+    /* Counter */
+    struct CNT : public Register<addr + 0x24, 16U, RegisterMode::RW>
+    {};
+
+    /* Prescaler, the counter clock is TIMxCLK / (PSC + 1) */
+    struct PSC : public Register<addr + 0x28, 16U, RegisterMode::RW>
+    {};
+
+    /* Auto-reload register, the period is ARR + 1 */
+    struct ARR : public Register<addr + 0x2C, 16U, RegisterMode::RW>
+    {};
+
+    /* Capture/compare registers, the compare value of the channel */
+    struct CCR1 : public Register<addr + 0x34, 16U, RegisterMode::RW>
+    {};
+    struct CCR2 : public Register<addr + 0x38, 16U, RegisterMode::RW>
+    {};
+    struct CCR3 : public Register<addr + 0x3C, 16U, RegisterMode::RW>
+    {};
+    struct CCR4 : public Register<addr + 0x40, 16U, RegisterMode::RW>
+    {};
+
+    /* Capture/compare channel n (1..4): its fields in CCMRx, CCER and CCRx */
+    template <uint32_t n>
+    struct Channel {
+        static_assert(n >= 1U && n <= 4U, "The timer has channels 1..4");
+
+    private:
+        static constexpr bool isFirst = (n % 2U) == 1U;
+        using CcmrBase = std::conditional_t<(n <= 2U), TIMCCMR1Base, TIMCCMR2Base>;
+
+    public:
+        using CCMR = std::conditional_t<(n <= 2U), TIM::CCMR1, TIM::CCMR2>;
+        using OCM =
+            TIM_OCM_Values<CCMR, isFirst ? 4 : 12, RegisterMode::RW, CcmrBase>;
+        using OCPE =
+            TIM_Enable_Values<CCMR, isFirst ? 3 : 11, RegisterMode::RW, CcmrBase>;
+        using CCS =
+            TIM_CCS_Values<CCMR, isFirst ? 0 : 8, RegisterMode::RW, CcmrBase>;
+        template <typename... T>
+        using CCMRSet = RegisterFieldSet<CCMR, CcmrBase, T...>;
+
+        using CCP =
+            TIM_CCP_Values<TIM::CCER, (n - 1U) * 4U + 1U, RegisterMode::RW, TIMCCERBase>;
+        using CCE =
+            TIM_Enable_Values<TIM::CCER, (n - 1U) * 4U, RegisterMode::RW, TIMCCERBase>;
+
+        using CCR = std::conditional_t<n == 1U, TIM::CCR1,
+                    std::conditional_t<n == 2U, TIM::CCR2,
+                    std::conditional_t<n == 3U, TIM::CCR3, TIM::CCR4>>>;
+    };
+};
+
+using TIM2 = TIM<0x40000000>;
+using TIM3 = TIM<0x40000400>;
+using TIM4 = TIM<0x40000800>;
+
+/* * * * * * * *
+ *  ADC
+ * * * * * * * */
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct ADC_Enable_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Disable = FieldValue<ADC_Enable_Values, BaseType, 0U>;
+    using Enable  = FieldValue<ADC_Enable_Values, BaseType, 1U>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct ADC_SR_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Clear   = FieldValue<ADC_SR_Values, BaseType, 0U>;
+    using Pending = FieldValue<ADC_SR_Values, BaseType, 1U>;
+};
+
+/* Sample time in ADC clock cycles, the conversion takes 12.5 more */
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct ADC_SMP_Values : public RegisterField<Reg, offset, 3U, AccessMode> {
+    using Cycles1_5   = FieldValue<ADC_SMP_Values, BaseType, 0b000>;
+    using Cycles7_5   = FieldValue<ADC_SMP_Values, BaseType, 0b001>;
+    using Cycles13_5  = FieldValue<ADC_SMP_Values, BaseType, 0b010>;
+    using Cycles28_5  = FieldValue<ADC_SMP_Values, BaseType, 0b011>;
+    using Cycles41_5  = FieldValue<ADC_SMP_Values, BaseType, 0b100>;
+    using Cycles55_5  = FieldValue<ADC_SMP_Values, BaseType, 0b101>;
+    using Cycles71_5  = FieldValue<ADC_SMP_Values, BaseType, 0b110>;
+    using Cycles239_5 = FieldValue<ADC_SMP_Values, BaseType, 0b111>;
+};
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct ADC_CR2_ALIGN_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Right = FieldValue<ADC_CR2_ALIGN_Values, BaseType, 0U>;
+    using Left  = FieldValue<ADC_CR2_ALIGN_Values, BaseType, 1U>;
+};
+
+/* External trigger of the regular group (ADC1 and ADC2) */
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct ADC_CR2_EXTSEL_Values : public RegisterField<Reg, offset, 3U, AccessMode> {
+    using Tim1Cc1  = FieldValue<ADC_CR2_EXTSEL_Values, BaseType, 0b000>;
+    using Tim1Cc2  = FieldValue<ADC_CR2_EXTSEL_Values, BaseType, 0b001>;
+    using Tim1Cc3  = FieldValue<ADC_CR2_EXTSEL_Values, BaseType, 0b010>;
+    using Tim2Cc2  = FieldValue<ADC_CR2_EXTSEL_Values, BaseType, 0b011>;
+    using Tim3Trgo = FieldValue<ADC_CR2_EXTSEL_Values, BaseType, 0b100>;
+    using Tim4Cc4  = FieldValue<ADC_CR2_EXTSEL_Values, BaseType, 0b101>;
+    using Exti11   = FieldValue<ADC_CR2_EXTSEL_Values, BaseType, 0b110>;
+    using SwStart  = FieldValue<ADC_CR2_EXTSEL_Values, BaseType, 0b111>;
+};
+
+template <uintptr_t addr>
+struct ADC {
+private:
+    struct ADCSRBase    {};
+    struct ADCCR1Base   {};
+    struct ADCCR2Base   {};
+    struct ADCSMPR1Base {};
+    struct ADCSMPR2Base {};
+
+public:
+    /* Status register, a flag is cleared by writing 0 */
+    struct SR : public Register<addr + 0x00, 32U, RegisterMode::RW,
+                                RegisterWrite::ZeroToClear> {
+        using STRT =
+            ADC_SR_Values<ADC::SR, 4, RegisterMode::RW, ADCSRBase>;
+        using JSTRT =
+            ADC_SR_Values<ADC::SR, 3, RegisterMode::RW, ADCSRBase>;
+        using JEOC =
+            ADC_SR_Values<ADC::SR, 2, RegisterMode::RW, ADCSRBase>;
+        using EOC =
+            ADC_SR_Values<ADC::SR, 1, RegisterMode::RW, ADCSRBase>;
+        using AWD =
+            ADC_SR_Values<ADC::SR, 0, RegisterMode::RW, ADCSRBase>;
+    };
+
+    /* Control register 1 */
+    struct CR1 : public Register<addr + 0x04, 32U, RegisterMode::RW> {
+        using AWDEN =
+            ADC_Enable_Values<ADC::CR1, 23, RegisterMode::RW, ADCCR1Base>;
+        using JAWDEN =
+            ADC_Enable_Values<ADC::CR1, 22, RegisterMode::RW, ADCCR1Base>;
+        /* ADC1 only, ADC2 reads it as 0 */
+        using DUALMOD = RegisterField<ADC::CR1, 16, 4U, RegisterMode::RW>;
+        using DISCNUM = RegisterField<ADC::CR1, 13, 3U, RegisterMode::RW>;
+        using JDISCEN =
+            ADC_Enable_Values<ADC::CR1, 12, RegisterMode::RW, ADCCR1Base>;
+        using DISCEN =
+            ADC_Enable_Values<ADC::CR1, 11, RegisterMode::RW, ADCCR1Base>;
+        using JAUTO =
+            ADC_Enable_Values<ADC::CR1, 10, RegisterMode::RW, ADCCR1Base>;
+        using AWDSGL =
+            ADC_Enable_Values<ADC::CR1, 9,  RegisterMode::RW, ADCCR1Base>;
+        using SCAN =
+            ADC_Enable_Values<ADC::CR1, 8,  RegisterMode::RW, ADCCR1Base>;
+        using JEOCIE =
+            ADC_Enable_Values<ADC::CR1, 7,  RegisterMode::RW, ADCCR1Base>;
+        using AWDIE =
+            ADC_Enable_Values<ADC::CR1, 6,  RegisterMode::RW, ADCCR1Base>;
+        using EOCIE =
+            ADC_Enable_Values<ADC::CR1, 5,  RegisterMode::RW, ADCCR1Base>;
+        using AWDCH = RegisterField<ADC::CR1, 0, 5U, RegisterMode::RW>;
+    };
+    template <typename... T>
+    using CR1Set = RegisterFieldSet<CR1, ADCCR1Base, T...>;
+
+    /* Control register 2 */
+    struct CR2 : public Register<addr + 0x08, 32U, RegisterMode::RW> {
+        /* temperature sensor and VREFINT, ADC1 only */
+        using TSVREFE =
+            ADC_Enable_Values<ADC::CR2, 23, RegisterMode::RW, ADCCR2Base>;
+        using SWSTART =
+            ADC_Enable_Values<ADC::CR2, 22, RegisterMode::RW, ADCCR2Base>;
+        using JSWSTART =
+            ADC_Enable_Values<ADC::CR2, 21, RegisterMode::RW, ADCCR2Base>;
+        using EXTTRIG =
+            ADC_Enable_Values<ADC::CR2, 20, RegisterMode::RW, ADCCR2Base>;
+        using EXTSEL =
+            ADC_CR2_EXTSEL_Values<ADC::CR2, 17, RegisterMode::RW, ADCCR2Base>;
+        using JEXTTRIG =
+            ADC_Enable_Values<ADC::CR2, 15, RegisterMode::RW, ADCCR2Base>;
+        using JEXTSEL = RegisterField<ADC::CR2, 12, 3U, RegisterMode::RW>;
+        using ALIGN =
+            ADC_CR2_ALIGN_Values<ADC::CR2, 11, RegisterMode::RW, ADCCR2Base>;
+        /* ADC1 only, ADC2 has no DMA request */
+        using DMA =
+            ADC_Enable_Values<ADC::CR2, 8,  RegisterMode::RW, ADCCR2Base>;
+        using RSTCAL =
+            ADC_Enable_Values<ADC::CR2, 3,  RegisterMode::RW, ADCCR2Base>;
+        using CAL =
+            ADC_Enable_Values<ADC::CR2, 2,  RegisterMode::RW, ADCCR2Base>;
+        using CONT =
+            ADC_Enable_Values<ADC::CR2, 1,  RegisterMode::RW, ADCCR2Base>;
+        using ADON =
+            ADC_Enable_Values<ADC::CR2, 0,  RegisterMode::RW, ADCCR2Base>;
+    };
+    template <typename... T>
+    using CR2Set = RegisterFieldSet<CR2, ADCCR2Base, T...>;
+
+    /* Sample time register 1, channels 10..17 */
+    struct SMPR1 : public Register<addr + 0x0C, 32U, RegisterMode::RW> {
+        using SMP17 =
+            ADC_SMP_Values<ADC::SMPR1, 21, RegisterMode::RW, ADCSMPR1Base>;
+        using SMP16 =
+            ADC_SMP_Values<ADC::SMPR1, 18, RegisterMode::RW, ADCSMPR1Base>;
+        using SMP15 =
+            ADC_SMP_Values<ADC::SMPR1, 15, RegisterMode::RW, ADCSMPR1Base>;
+        using SMP14 =
+            ADC_SMP_Values<ADC::SMPR1, 12, RegisterMode::RW, ADCSMPR1Base>;
+        using SMP13 =
+            ADC_SMP_Values<ADC::SMPR1, 9, RegisterMode::RW, ADCSMPR1Base>;
+        using SMP12 =
+            ADC_SMP_Values<ADC::SMPR1, 6, RegisterMode::RW, ADCSMPR1Base>;
+        using SMP11 =
+            ADC_SMP_Values<ADC::SMPR1, 3, RegisterMode::RW, ADCSMPR1Base>;
+        using SMP10 =
+            ADC_SMP_Values<ADC::SMPR1, 0, RegisterMode::RW, ADCSMPR1Base>;
+    };
+    template <typename... T>
+    using SMPR1Set = RegisterFieldSet<SMPR1, ADCSMPR1Base, T...>;
+
+    /* Sample time register 2, channels 0..9 */
+    struct SMPR2 : public Register<addr + 0x10, 32U, RegisterMode::RW> {
+        using SMP9 =
+            ADC_SMP_Values<ADC::SMPR2, 27, RegisterMode::RW, ADCSMPR2Base>;
+        using SMP8 =
+            ADC_SMP_Values<ADC::SMPR2, 24, RegisterMode::RW, ADCSMPR2Base>;
+        using SMP7 =
+            ADC_SMP_Values<ADC::SMPR2, 21, RegisterMode::RW, ADCSMPR2Base>;
+        using SMP6 =
+            ADC_SMP_Values<ADC::SMPR2, 18, RegisterMode::RW, ADCSMPR2Base>;
+        using SMP5 =
+            ADC_SMP_Values<ADC::SMPR2, 15, RegisterMode::RW, ADCSMPR2Base>;
+        using SMP4 =
+            ADC_SMP_Values<ADC::SMPR2, 12, RegisterMode::RW, ADCSMPR2Base>;
+        using SMP3 =
+            ADC_SMP_Values<ADC::SMPR2, 9, RegisterMode::RW, ADCSMPR2Base>;
+        using SMP2 =
+            ADC_SMP_Values<ADC::SMPR2, 6, RegisterMode::RW, ADCSMPR2Base>;
+        using SMP1 =
+            ADC_SMP_Values<ADC::SMPR2, 3, RegisterMode::RW, ADCSMPR2Base>;
+        using SMP0 =
+            ADC_SMP_Values<ADC::SMPR2, 0, RegisterMode::RW, ADCSMPR2Base>;
+    };
+    template <typename... T>
+    using SMPR2Set = RegisterFieldSet<SMPR2, ADCSMPR2Base, T...>;
+
+    /* Regular sequence register 1: the length and the 13th..16th channels */
+    struct SQR1 : public Register<addr + 0x2C, 32U, RegisterMode::RW> {
+        /* the number of the conversions - 1 */
+        using L = RegisterField<ADC::SQR1, 20, 4U, RegisterMode::RW>;
+        using SQ16 = RegisterField<ADC::SQR1, 15, 5U, RegisterMode::RW>;
+        using SQ15 = RegisterField<ADC::SQR1, 10, 5U, RegisterMode::RW>;
+        using SQ14 = RegisterField<ADC::SQR1, 5, 5U, RegisterMode::RW>;
+        using SQ13 = RegisterField<ADC::SQR1, 0, 5U, RegisterMode::RW>;
+    };
+
+    /* Regular sequence register 2, the 7th..12th channels */
+    struct SQR2 : public Register<addr + 0x30, 32U, RegisterMode::RW> {
+        using SQ12 = RegisterField<ADC::SQR2, 25, 5U, RegisterMode::RW>;
+        using SQ11 = RegisterField<ADC::SQR2, 20, 5U, RegisterMode::RW>;
+        using SQ10 = RegisterField<ADC::SQR2, 15, 5U, RegisterMode::RW>;
+        using SQ9 = RegisterField<ADC::SQR2, 10, 5U, RegisterMode::RW>;
+        using SQ8 = RegisterField<ADC::SQR2, 5, 5U, RegisterMode::RW>;
+        using SQ7 = RegisterField<ADC::SQR2, 0, 5U, RegisterMode::RW>;
+    };
+
+    /* Regular sequence register 3, the 1st..6th channels */
+    struct SQR3 : public Register<addr + 0x34, 32U, RegisterMode::RW> {
+        using SQ6 = RegisterField<ADC::SQR3, 25, 5U, RegisterMode::RW>;
+        using SQ5 = RegisterField<ADC::SQR3, 20, 5U, RegisterMode::RW>;
+        using SQ4 = RegisterField<ADC::SQR3, 15, 5U, RegisterMode::RW>;
+        using SQ3 = RegisterField<ADC::SQR3, 10, 5U, RegisterMode::RW>;
+        using SQ2 = RegisterField<ADC::SQR3, 5, 5U, RegisterMode::RW>;
+        using SQ1 = RegisterField<ADC::SQR3, 0, 5U, RegisterMode::RW>;
+    };
+
+    /* Regular data register, ADC2 data in the high half in dual mode */
+    struct DR : public Register<addr + 0x4C, 32U, RegisterMode::Read>
+    {};
+};
+
+using ADC1 = ADC<0x40012400>;
+using ADC2 = ADC<0x40012800>;
+
+/* * * * * * * *
+ *  AFIO
+ * * * * * * * */
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct AFIO_EXTICR_Values : public RegisterField<Reg, offset, 4U, AccessMode> {
+    using PA = FieldValue<AFIO_EXTICR_Values, BaseType, 0U>;
+    using PB = FieldValue<AFIO_EXTICR_Values, BaseType, 1U>;
+    using PC = FieldValue<AFIO_EXTICR_Values, BaseType, 2U>;
+    using PD = FieldValue<AFIO_EXTICR_Values, BaseType, 3U>;
+    using PE = FieldValue<AFIO_EXTICR_Values, BaseType, 4U>;
+};
+
+struct AFIO {
+private:
+    static constexpr uintptr_t base = 0x40010000U;
+    struct AFIOEXTICRBase {};
+
+public:
+    /* External interrupt configuration registers 1..4 (n = 0..3),
+     *   4 lines per register
+     */
+    template <uint32_t n>
+    struct EXTICR : public Register<base + 0x08 + n * 4U, 32U, RegisterMode::RW> {
+        template <uint32_t line>
+        using EXTI = AFIO_EXTICR_Values<AFIO::EXTICR<n>, (line % 4U) * 4U,
+                                        RegisterMode::RW, AFIOEXTICRBase>;
+    };
+};
+
+/* * * * * * * *
+ *  EXTI
+ * * * * * * * */
+
+template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
+struct EXTI_Line_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
+    using Disable = FieldValue<EXTI_Line_Values, BaseType, 0U>;
+    using Enable  = FieldValue<EXTI_Line_Values, BaseType, 1U>;
+};
+
+struct EXTI {
+private:
+    static constexpr uintptr_t base = 0x40010400U;
+    struct EXTIIMRBase  {};
+    struct EXTIRTSRBase {};
+    struct EXTIFTSRBase {};
+
+public:
+    /* Interrupt mask register */
+    struct IMR : public Register<base + 0x00, 32U, RegisterMode::RW> {
+        template <uint32_t line>
+        using MR = EXTI_Line_Values<EXTI::IMR, line, RegisterMode::RW, EXTIIMRBase>;
+    };
+
+    /* Rising trigger selection register */
+    struct RTSR : public Register<base + 0x08, 32U, RegisterMode::RW> {
+        template <uint32_t line>
+        using TR = EXTI_Line_Values<EXTI::RTSR, line, RegisterMode::RW, EXTIRTSRBase>;
+    };
+
+    /* Falling trigger selection register */
+    struct FTSR : public Register<base + 0x0C, 32U, RegisterMode::RW> {
+        template <uint32_t line>
+        using TR = EXTI_Line_Values<EXTI::FTSR, line, RegisterMode::RW, EXTIFTSRBase>;
+    };
+
+    /* Software interrupt event register */
+    struct SWIER : public Register<base + 0x10, 32U, RegisterMode::RW,
+                                   RegisterWrite::OneToSet>
+    {};
+
+    /* Pending register, a pending line is cleared by writing 1 */
+    struct PR : public Register<base + 0x14, 32U, RegisterMode::RW,
+                                RegisterWrite::OneToClear>
+    {};
 };
 
 /* * * * * * * *
@@ -56,8 +1004,8 @@ public:
 
 template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
 struct GPIO_IDR_Values : public RegisterField<Reg, offset, 1U, AccessMode> {
-    using IsHigh = FieldValue<GPIO_IDR_Values, BaseType, 0U>;
-    using IsLow  = FieldValue<GPIO_IDR_Values, BaseType, 1U>;
+    using IsLow  = FieldValue<GPIO_IDR_Values, BaseType, 0U>;
+    using IsHigh = FieldValue<GPIO_IDR_Values, BaseType, 1U>;
 };
 
 template <typename Reg, size_t offset, typename AccessMode, typename BaseType>
@@ -94,11 +1042,26 @@ struct GPIO_CR_Value : public RegisterField<Reg, offset, 4U, AccessMode> {
     using OutPP50MHz    = FieldValue<GPIO_CR_Value, BaseType, 0b0011>;
     using OutPP2MHz     = FieldValue<GPIO_CR_Value, BaseType, 0b0010>;
     using OutPP10MHz    = FieldValue<GPIO_CR_Value, BaseType, 0b0001>;
+    using OutOD50MHz    = FieldValue<GPIO_CR_Value, BaseType, 0b0111>;
+    using OutOD2MHz     = FieldValue<GPIO_CR_Value, BaseType, 0b0110>;
+    using OutOD10MHz    = FieldValue<GPIO_CR_Value, BaseType, 0b0101>;
+    /* as Alternate function output */
+    using AltPP50MHz    = FieldValue<GPIO_CR_Value, BaseType, 0b1011>;
+    using AltPP2MHz     = FieldValue<GPIO_CR_Value, BaseType, 0b1010>;
+    using AltPP10MHz    = FieldValue<GPIO_CR_Value, BaseType, 0b1001>;
+    using AltOD50MHz    = FieldValue<GPIO_CR_Value, BaseType, 0b1111>;
+    using AltOD2MHz     = FieldValue<GPIO_CR_Value, BaseType, 0b1110>;
+    using AltOD10MHz    = FieldValue<GPIO_CR_Value, BaseType, 0b1101>;
 };
 
 
 template <uintptr_t addr>
 struct GPIO {
+    /* GPIOA is 0, GPIOB is 1, ... */
+    static constexpr uint32_t Index = (addr - 0x40010800U) / 0x400U;
+    /* IOPxEN bit in RCC::APB2ENR */
+    static constexpr uint32_t ClockEnableOffset = 2U + Index;
+
 private:
     struct GPIOBSRRBase  {};
     struct GPIOMODERBase {};
@@ -123,7 +1086,7 @@ public:
     };
     template <typename... T>
     using CRLSet =
-        RegisterFieldSet<addr + 0x00, 32,  RegisterMode::RW, GPIOCRLBase, T...>;
+        RegisterFieldSet<CRL, GPIOCRLBase, T...>;
 
     /* Control register (High) */
     struct CRH : public Register<addr + 0x04, 32,  RegisterMode::RW> {
@@ -140,7 +1103,7 @@ public:
     };
     template <typename... T>
     using CRHSet =
-        RegisterFieldSet<addr + 0x00, 32,  RegisterMode::RW, GPIOCRHBase, T...>;
+        RegisterFieldSet<CRH, GPIOCRHBase, T...>;
 
     /* IDR */
     struct IDR : public Register<addr + 0x08, 32, RegisterMode::Read> {
@@ -148,7 +1111,7 @@ public:
             GPIO_IDR_Values<GPIO::IDR, 15, RegisterMode::Read, GPIOIDRBase>;
         /* ... */
         using IDR1 =
-            GPIO_IDR_Values<GPIO::IDR, 0, RegisterMode::Read, GPIOIDRBase>;
+            GPIO_IDR_Values<GPIO::IDR, 1, RegisterMode::Read, GPIOIDRBase>;
         using IDR0 =
             GPIO_IDR_Values<GPIO::IDR, 0, RegisterMode::Read, GPIOIDRBase>;
 
@@ -157,7 +1120,7 @@ public:
     };
     template <typename... T>
     using IDRSet =
-        RegisterFieldSet<addr + 0x08, 32, RegisterMode::Read, GPIOIDRBase, T...>;
+        RegisterFieldSet<IDR, GPIOIDRBase, T...>;
 
     /* ODR */
     struct ODR : public Register<addr + 0x0C, 32,  RegisterMode::RW> {
@@ -174,10 +1137,11 @@ public:
     };
     template <typename... T>
     using ODRSet =
-        RegisterFieldSet<addr + 0x0C, 32, RegisterMode::Read, GPIOODRBase, T...>;
+        RegisterFieldSet<ODR, GPIOODRBase, T...>;
 
     /* BSRR */
-    struct BSRR : public Register<addr + 0x10, 32, RegisterMode::Write> {
+    struct BSRR : public Register<addr + 0x10, 32, RegisterMode::Write,
+                                  RegisterWrite::WriteOnly> {
         using BR15 =
             GPIO_BSRR_BR_Values<GPIO::BSRR, 31, RegisterMode::Write, GPIOBSRRBase>;
         /* ... */
@@ -196,7 +1160,7 @@ public:
     };
     template <typename... T>
     using BSRRSet =
-        RegisterFieldSet<addr + 0x10, 32, RegisterMode::Write, GPIOBSRRBase, T...>;
+        RegisterFieldSet<BSRR, GPIOBSRRBase, T...>;
 };
 
 
@@ -0,0 +1,333 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if !defined(__arm__)
+    #include <atomic>
+#endif
+
+#include "utils.hpp"
+
+namespace Utils {
+namespace Sync {
+
+/* 32-bit index shared by the contexts (interrupts, main loop)
+ *
+ * Load() is an acquire, Store() is a release. On target these are plain
+ *   accesses with DMB and the compare-exchange is LDREX/STREX, on the host
+ *   (threads instead of interrupts) it is std::atomic.
+ */
+class SharedIndex {
+public:
+    explicit constexpr SharedIndex(uint32_t init = 0U) : value(init)
+    {}
+
+#if defined(__arm__)
+    inline uint32_t Load() const {
+        const uint32_t result = value;
+        __dmb();
+        return result;
+    }
+
+    inline void Store(uint32_t newValue) {
+        __dmb();
+        value = newValue;
+    }
+
+    /* may fail spuriously (an interrupt between LDREX and STREX) */
+    inline bool CompareExchange(uint32_t &expected, uint32_t desired) {
+        const uint32_t current = __ldrex(&value);
+        if (current != expected) {
+            __clrex();
+            expected = current;
+            return false;
+        }
+        if (__strex(desired, &value) != 0U) {
+            return false;
+        }
+        __dmb();
+        return true;
+    }
+
+private:
+    volatile uint32_t value;
+#else
+    inline uint32_t Load() const {
+        return value.load(std::memory_order_acquire);
+    }
+
+    inline void Store(uint32_t newValue) {
+        value.store(newValue, std::memory_order_release);
+    }
+
+    inline bool CompareExchange(uint32_t &expected, uint32_t desired) {
+        return value.compare_exchange_weak(expected, desired,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<uint32_t> value;
+#endif
+};
+
+} /* namespace Sync */
+} /* namespace Utils */
+
+/* Contiguous part of a ring buffer, for zero-copy access */
+template <typename T>
+struct RingSpan {
+    T *data;
+    size_t size;
+};
+
+/* template for SpscRing class
+ *
+ * Lock-free ring buffer for one producer and one consumer, e.g. an interrupt
+ *   and the main loop. Never blocks: Push fails if the buffer is full,
+ *   Pop fails if it is empty.
+ *
+ * The indices run freely and wrap modulo 2^32, the capacity is a power of
+ *   two, so the position in the buffer is a mask.
+ *
+ * T        - trivially copyable item
+ * capacity - power of two
+ *
+ * Zero-copy consumer:
+ *   const auto span = rx.ReadSpan();   // the readable items up to the wrap
+ *   Parse(span.data, span.size);
+ *   rx.Consume(span.size);
+ */
+template <typename T, size_t capacity>
+class SpscRing {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "Items are copied as is");
+    static_assert(capacity >= 2U && capacity <= (1UL << 31U) &&
+                  (capacity & (capacity - 1U)) == 0U,
+                  "Capacity must be a power of two");
+
+    static constexpr size_t Capacity = capacity;
+
+    /* Producer */
+
+    bool Push(const T &item) {
+        const uint32_t h = head.Load();
+        if (h - tail.Load() == capacity) {
+            return false;
+        }
+        buffer[h & mask] = item;
+        head.Store(h + 1U);
+        return true;
+    }
+
+    /* up to n items, returns the number of the pushed ones */
+    size_t Push(const T *items, size_t n) {
+        const uint32_t h = head.Load();
+        n = std::min(n, capacity - static_cast<size_t>(h - tail.Load()));
+
+        const size_t first = std::min(n, capacity - (h & mask));
+        std::copy_n(items, first, &buffer[h & mask]);
+        std::copy_n(items + first, n - first, &buffer[0]);
+
+        head.Store(h + static_cast<uint32_t>(n));
+        return n;
+    }
+
+    /* the free space up to the wrap, filled in place and then committed */
+    RingSpan<T> WriteSpan() {
+        const uint32_t h = head.Load();
+        const size_t free = capacity - static_cast<size_t>(h - tail.Load());
+        return {&buffer[h & mask], std::min(free, capacity - (h & mask))};
+    }
+
+    void Commit(size_t n) {
+        head.Store(head.Load() + static_cast<uint32_t>(n));
+    }
+
+    /* Consumer */
+
+    bool Pop(T &item) {
+        const uint32_t t = tail.Load();
+        if (head.Load() == t) {
+            return false;
+        }
+        item = buffer[t & mask];
+        tail.Store(t + 1U);
+        return true;
+    }
+
+    /* up to n items, returns the number of the popped ones */
+    size_t Pop(T *items, size_t n) {
+        const uint32_t t = tail.Load();
+        n = std::min(n, static_cast<size_t>(head.Load() - t));
+
+        const size_t first = std::min(n, capacity - (t & mask));
+        std::copy_n(&buffer[t & mask], first, items);
+        std::copy_n(&buffer[0], n - first, items + first);
+
+        tail.Store(t + static_cast<uint32_t>(n));
+        return n;
+    }
+
+    /* the stored items up to the wrap, released by Consume */
+    RingSpan<const T> ReadSpan() const {
+        const uint32_t t = tail.Load();
+        const size_t used = static_cast<size_t>(head.Load() - t);
+        return {&buffer[t & mask], std::min(used, capacity - (t & mask))};
+    }
+
+    void Consume(size_t n) {
+        tail.Store(tail.Load() + static_cast<uint32_t>(n));
+    }
+
+    /* Both */
+
+    size_t Size() const {
+        return static_cast<size_t>(head.Load() - tail.Load());
+    }
+
+    bool IsEmpty() const {
+        return Size() == 0U;
+    }
+
+private:
+    static constexpr uint32_t mask = static_cast<uint32_t>(capacity - 1U);
+
+    Utils::Sync::SharedIndex head;  /* written by the producer */
+    Utils::Sync::SharedIndex tail;  /* written by the consumer */
+    T buffer[capacity];
+};
+
+/* template for MpscRing class
+ *
+ * Lock-free ring buffer for many producers (interrupts of any priority,
+ *   the main loop) and one consumer. The producers reserve the slots with
+ *   a compare-exchange of the head and never wait for each other: a preempted
+ *   producer only delays the consumer, which stops at the first slot that
+ *   is not written yet.
+ *
+ * Every slot has a sequence number: it equals the position when the slot is
+ *   free for the position, and the position + 1 when the item is written.
+ *
+ * T        - trivially copyable item
+ * capacity - power of two
+ */
+template <typename T, size_t capacity>
+class MpscRing {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "Items are copied as is");
+    static_assert(capacity >= 2U && capacity <= (1UL << 31U) &&
+                  (capacity & (capacity - 1U)) == 0U,
+                  "Capacity must be a power of two");
+
+    static constexpr size_t Capacity = capacity;
+
+    MpscRing() {
+        for (uint32_t i = 0; i < capacity; ++i) {
+            sequence[i].Store(i);
+        }
+    }
+
+    /* Producers */
+
+    bool Push(const T &item) {
+        return Push(&item, 1U);
+    }
+
+    /* all n items or none, the items are consecutive in the buffer */
+    bool Push(const T *items, size_t n) {
+        if (n == 0U || n > capacity) {
+            return n == 0U;
+        }
+
+        const uint32_t count = static_cast<uint32_t>(n);
+        uint32_t pos = head.Load();
+        for (;;) {
+            /* the consumer frees the slots in order: if the last one is free,
+               all of them are */
+            const uint32_t last = pos + count - 1U;
+            const int32_t diff =
+                static_cast<int32_t>(sequence[last & mask].Load() - last);
+            if (diff < 0) {
+                return false;       /* full */
+            }
+            if (diff > 0) {
+                pos = head.Load();  /* another producer took it */
+                continue;
+            }
+            if (head.CompareExchange(pos, pos + count)) {
+                break;
+            }
+        }
+
+        for (uint32_t i = 0; i < count; ++i) {
+            buffer[(pos + i) & mask] = items[i];
+            sequence[(pos + i) & mask].Store(pos + i + 1U);
+        }
+        return true;
+    }
+
+    /* Consumer */
+
+    bool Pop(T &item) {
+        return Pop(&item, 1U) == 1U;
+    }
+
+    /* up to n items, returns the number of the popped ones */
+    size_t Pop(T *items, size_t n) {
+        size_t popped = 0;
+        while (popped < n) {
+            const auto span = ReadSpan();
+            if (span.size == 0U) {
+                break;
+            }
+            const size_t chunk = std::min(span.size, n - popped);
+            std::copy_n(span.data, chunk, items + popped);
+            Consume(chunk);
+            popped += chunk;
+        }
+        return popped;
+    }
+
+    /* the written items up to the wrap or up to the first unwritten slot */
+    RingSpan<const T> ReadSpan() const {
+        const uint32_t t = tail.Load();
+        const size_t end = capacity - (t & mask);
+        size_t n = 0;
+        while (n < end &&
+               sequence[(t + n) & mask].Load() == t + static_cast<uint32_t>(n) + 1U) {
+            ++n;
+        }
+        return {&buffer[t & mask], n};
+    }
+
+    void Consume(size_t n) {
+        const uint32_t t = tail.Load();
+        for (uint32_t i = 0; i < n; ++i) {
+            sequence[(t + i) & mask].Store(t + i + capacity);
+        }
+        tail.Store(t + static_cast<uint32_t>(n));
+    }
+
+    /* the reserved items, some of them may be not written yet */
+    size_t Size() const {
+        return static_cast<size_t>(head.Load() - tail.Load());
+    }
+
+    bool IsEmpty() const {
+        return Size() == 0U;
+    }
+
+private:
+    static constexpr uint32_t mask = static_cast<uint32_t>(capacity - 1U);
+
+    Utils::Sync::SharedIndex head;
+    Utils::Sync::SharedIndex tail;
+    Utils::Sync::SharedIndex sequence[capacity];
+    T buffer[capacity];
+};
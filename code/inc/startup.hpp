@@ -0,0 +1,172 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* Variables in .noinit are not touched by the startup: after a reset they
+ *   keep the values from before it (garbage after a power-up, so check them
+ *   with a magic word).
+ *
+ * Example:
+ *   HWREG_NOINIT static uint32_t resetCount;
+ */
+#if defined(__arm__)
+#define HWREG_NOINIT __attribute__((section(".noinit")))
+#else
+#define HWREG_NOINIT
+#endif
+
+/* Memory initialization of Reset_Handler (startup_stm32f103xb.cpp)
+ *
+ * .ramfunc and .data are copied from the flash and .bss is zeroed in bursts
+ *   of 4 words: LDMIA/STMIA move 16 bytes in 5 + 5 cycles, LDR/STR take 4
+ *   cycles per word, and the loop overhead is paid once per burst. The words
+ *   left over, then the bytes (an odd-sized region), go one by one.
+ *
+ * The start addresses must be word-aligned, the linker script aligns the
+ *   sections.
+ *
+ * With HWREG_PACK_DATA the .data image in the flash is packed by
+ *   tools/pack_data.py and Unpack replaces the copy. The format is a byte
+ *   LZ77, a token byte T followed by:
+ *     T < 0x80   T + 1 literal bytes
+ *     T >= 0x80  a little-endian 16-bit offset: (T & 0x7F) + 4 bytes are
+ *                copied from that far back in the output, the copy may
+ *                overlap itself (a run of one byte is offset 1)
+ */
+class Startup {
+public:
+    static void Copy(void *dst, const void *src, size_t bytes) {
+        uint32_t *d = static_cast<uint32_t *>(dst);
+        const uint32_t *s = static_cast<const uint32_t *>(src);
+        size_t bursts = bytes / burstBytes;
+
+#if defined(__arm__)
+        if (bursts != 0U) {
+            __asm__ volatile(
+                "1: ldmia %[s]!, {r3, r4, r5, r6}  \n"
+                "   stmia %[d]!, {r3, r4, r5, r6}  \n"
+                "   subs  %[n], %[n], #1           \n"
+                "   bne   1b                       \n"
+                : [d] "+r"(d), [s] "+r"(s), [n] "+r"(bursts)
+                :
+                : "r3", "r4", "r5", "r6", "cc", "memory");
+        }
+#else
+        for (; bursts != 0U; --bursts) {
+            d[0] = s[0];
+            d[1] = s[1];
+            d[2] = s[2];
+            d[3] = s[3];
+            d += burstWords;
+            s += burstWords;
+        }
+#endif
+
+        for (size_t words = (bytes % burstBytes) / 4U; words != 0U; --words) {
+            *d++ = *s++;
+        }
+
+        uint8_t *db = reinterpret_cast<uint8_t *>(d);
+        const uint8_t *sb = reinterpret_cast<const uint8_t *>(s);
+        for (size_t tail = bytes % 4U; tail != 0U; --tail) {
+            *db++ = *sb++;
+        }
+    }
+
+    static void Zero(void *dst, size_t bytes) {
+        uint32_t *d = static_cast<uint32_t *>(dst);
+        size_t bursts = bytes / burstBytes;
+
+#if defined(__arm__)
+        if (bursts != 0U) {
+            __asm__ volatile(
+                "   movs  r3, #0                   \n"
+                "   movs  r4, #0                   \n"
+                "   movs  r5, #0                   \n"
+                "   movs  r6, #0                   \n"
+                "1: stmia %[d]!, {r3, r4, r5, r6}  \n"
+                "   subs  %[n], %[n], #1           \n"
+                "   bne   1b                       \n"
+                : [d] "+r"(d), [n] "+r"(bursts)
+                :
+                : "r3", "r4", "r5", "r6", "cc", "memory");
+        }
+#else
+        for (; bursts != 0U; --bursts) {
+            d[0] = 0U;
+            d[1] = 0U;
+            d[2] = 0U;
+            d[3] = 0U;
+            d += burstWords;
+        }
+#endif
+
+        for (size_t words = (bytes % burstBytes) / 4U; words != 0U; --words) {
+            *d++ = 0U;
+        }
+
+        uint8_t *db = reinterpret_cast<uint8_t *>(d);
+        for (size_t tail = bytes % 4U; tail != 0U; --tail) {
+            *db++ = 0U;
+        }
+    }
+
+    static void Unpack(void *dst, const void *src, size_t bytes) {
+        uint8_t *d = static_cast<uint8_t *>(dst);
+        uint8_t *const end = d + bytes;
+        const uint8_t *s = static_cast<const uint8_t *>(src);
+
+        while (d < end) {
+            const uint32_t token = *s++;
+            if (token < packMatch) {
+                for (uint32_t n = token + 1U; n != 0U; --n) {
+                    *d++ = *s++;
+                }
+            } else {
+                const uint32_t offset = s[0] | (static_cast<uint32_t>(s[1]) << 8);
+                const uint8_t *from = d - offset;
+                s += 2;
+                /* byte by byte: the bytes just written are read back */
+                for (uint32_t n = (token & ~packMatch) + packMinMatch; n != 0U; --n) {
+                    *d++ = *from++;
+                }
+            }
+        }
+    }
+
+    /* core cycles from the reset to main(), with the constructors;
+     *   from the DWT cycle counter, which the startup enables first
+     */
+    static inline uint32_t BootCycles() {
+        return bootCycles;
+    }
+
+    /* Reset_Handler only */
+    static inline void SetBootCycles(uint32_t cycles) {
+        bootCycles = cycles;
+    }
+
+    /* core cycles of the .data init: the copy, or the unpacking */
+    static inline uint32_t DataCycles() {
+        return dataCycles;
+    }
+
+    /* Reset_Handler only */
+    static inline void SetDataCycles(uint32_t cycles) {
+        dataCycles = cycles;
+    }
+
+private:
+    static constexpr size_t burstWords = 4U;
+    static constexpr size_t burstBytes = burstWords * 4U;
+
+    /* the format of tools/pack_data.py */
+    static constexpr uint32_t packMatch = 0x80U;
+    static constexpr uint32_t packMinMatch = 4U;
+
+    static inline uint32_t bootCycles = 0U;
+    static inline uint32_t dataCycles = 0U;
+};
@@ -0,0 +1,112 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include "utils.hpp"
+#include "bus.hpp"
+
+namespace Utils {
+namespace Sync {
+
+/* Concurrency policies for read-modify-write of a register
+ *
+ * Each policy writes the bits under the mask and keeps the others:
+ *   Policy::Modify<T, Bus>(address, mask, value)
+ *   The value must be within the mask. It is not masked again: at -Og GCC
+ *   turns (x & ~mask) | (value & mask) into an xor form, 2 instructions
+ *   longer even when both are constants.
+ *
+ * None             - plain load + store, for single-context code
+ * Exclusive        - LDREX/STREX loop, lock-free. After maxRetries failed
+ *                    attempts (an interrupt keeps clearing the monitor) it
+ *                    falls back to CriticalSection instead of spinning forever
+ * CriticalSection  - load + store with interrupts masked by PRIMASK
+ * BitBand          - a bit-band store per bit of the mask. Every bit is
+ *                    changed atomically, but not all of them at once
+ *
+ * See bench/target/sync_policies.cpp for the cycles of every policy.
+ */
+
+struct None {
+    template <typename T, typename Bus>
+    static inline void Modify(uintptr_t address, T mask, T value) {
+        T newValue = Bus::template Load<T>(address);
+        newValue &= ~mask;
+        newValue |= value;
+        Bus::template Store<T>(address, newValue);
+    }
+};
+
+struct CriticalSection {
+    template <typename T, typename Bus>
+    static inline void Modify(uintptr_t address, T mask, T value) {
+        const uint32_t primask = __get_primask();
+        __disable_irq();
+
+        None::Modify<T, Bus>(address, mask, value);
+
+        __set_primask(primask);
+    }
+};
+
+struct Exclusive {
+    static constexpr uint32_t maxRetries = 8U;
+
+    template <typename T, typename Bus>
+    static inline void Modify(uintptr_t address, T mask, T value) {
+        static_assert(sizeof(T) == sizeof(uint32_t),
+                      "LDREX/STREX are used for 32-bit registers only");
+
+        for (uint32_t i = 0; i < maxRetries; ++i) {
+            uint32_t newValue = Bus::LoadExclusive(address);
+            newValue &= ~mask;
+            newValue |= value;
+            if (0U == Bus::StoreExclusive(address, newValue)) {
+                return;
+            }
+        }
+
+        CriticalSection::Modify<T, Bus>(address, mask, value);
+    }
+};
+
+struct BitBand {
+    template <typename T, typename Bus>
+    static inline void Modify(uintptr_t address, T mask, T value) {
+        assert(BitBandAlias::IsInRegion(address));
+
+        for (uint32_t bit = 0; bit < sizeof(T) * 8U; ++bit) {
+            if (mask & (1U << bit)) {
+                Bus::template Store<uint32_t>(
+                    BitBandAlias::Address(address, bit),
+                    (value >> bit) & 1U
+                );
+            }
+        }
+    }
+};
+
+
+/* Atomic
+ *
+ * T        - register type
+ * Bus      - bus policy of the register, see bus.hpp
+ * Policy   - concurrency policy, declared above
+ */
+template <typename T, typename Bus, typename Policy = Exclusive>
+class Atomic {
+public:
+    static void Set(T addr, T mask, T val, T offset) {
+        Policy::template Modify<T, Bus>(
+            addr,
+            static_cast<T>(mask << offset),
+            static_cast<T>(val << offset)
+        );
+    }
+};
+
+} /* namespace Sync */
+} /* namespace Utils */
@@ -0,0 +1,143 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstdint>
+
+#include "register.hpp"
+#include "regs_cm3.hpp"
+#include "cycle_counter.hpp"
+#include "utils.hpp"
+
+/* template for Timebase class
+ *
+ * 1 ms SysTick tick, cycle-accurate microsecond delays on the DWT counter
+ *   and a tickless sleep. All the constants are computed from the clock
+ *   configuration at compile time.
+ *
+ * Tickless sleep: while the core sleeps until a deadline, the SysTick period
+ *   is stretched up to the deadline (at most LOAD::Max cycles, ~233 ms at
+ *   72 MHz), so the core is woken once per period instead of once per
+ *   millisecond. The ticks are counted at the end of every period, so Now()
+ *   read by an interrupt during a long period lags behind.
+ *
+ * Clock - ClockConfig from clock.hpp
+ *
+ * Example:
+ *   using SystemTime = Timebase<SystemClock>;
+ *   IrqHandler<IrqN::SysTick, SystemTime::OnTick>    // in VectorTable
+ *
+ *   SystemTime::Init();
+ *   SystemTime::DelayUs(10);       // busy wait
+ *   SystemTime::DelayMs(500);      // WFI
+ */
+template <typename Clock>
+class Timebase {
+public:
+    static constexpr uint32_t TickHz = 1000U;
+    static constexpr uint32_t CyclesPerTick = Clock::HClk / TickHz;
+    static constexpr uint32_t CyclesPerUs = Clock::HClk / 1'000'000U;
+    /* the longest SysTick period of the tickless sleep */
+    static constexpr uint32_t MaxSleepTicks = (SysTick::LOAD::Max + 1U) / CyclesPerTick;
+
+    static_assert(Clock::HClk % TickHz == 0U, "HCLK must be a multiple of 1 kHz");
+    static_assert(CyclesPerTick - 1U <= SysTick::LOAD::Max, "The tick doesn't fit SysTick");
+    static_assert(CyclesPerUs > 0U, "HCLK must be at least 1 MHz");
+
+    /* A point in time, in ticks
+     *
+     * The tick counter wraps every ~49 days, the comparisons are correct
+     *   for deadlines up to ~24 days ahead.
+     */
+    class Deadline {
+    public:
+        static Deadline In(uint32_t ms) {
+            return Deadline(Now() + ms);
+        }
+
+        bool IsExpired() const {
+            return static_cast<int32_t>(Now() - end) >= 0;
+        }
+
+        uint32_t Remaining() const {
+            const int32_t left = static_cast<int32_t>(end - Now());
+            return (left > 0) ? static_cast<uint32_t>(left) : 0U;
+        }
+
+        /* tickless sleep until the deadline */
+        void Sleep() const {
+            SleepUntil(end);
+        }
+
+    private:
+        explicit Deadline(uint32_t endTick) : end(endTick)
+        {}
+
+        uint32_t end;
+    };
+
+    /* SysTick from the core clock, 1 ms period, and the cycle counter */
+    static void Init() {
+        CycleCounter::Enable();
+
+        SysTick::LOAD::Set(CyclesPerTick - 1U);
+        SysTick::VAL::Set(0U);
+        SysTick::CTRL::Set(SysTick::CTRL::CLKSOURCE::Mask |
+                           SysTick::CTRL::TICKINT::Mask |
+                           SysTick::CTRL::ENABLE::Mask);
+    }
+
+    /* SysTick handler */
+    static void OnTick() {
+        ticks = ticks + period;
+        period = pending;
+
+        /* the reload value is used after the running period */
+        uint32_t next = 1U;
+        if (sleeping) {
+            const int32_t left = static_cast<int32_t>(wakeAt - (ticks + period));
+            if (left > 1) {
+                next = (static_cast<uint32_t>(left) < MaxSleepTicks) ?
+                       static_cast<uint32_t>(left) : MaxSleepTicks;
+            }
+        }
+        if (next != pending) {
+            pending = next;
+            SysTick::LOAD::Set(next * CyclesPerTick - 1U);
+        }
+    }
+
+    /* ticks (ms) since Init() */
+    static inline uint32_t Now() {
+        return ticks;
+    }
+
+    /* busy wait, up to ~59 s at 72 MHz */
+    static inline void DelayUs(uint32_t us) {
+        const uint32_t start = CycleCounter::Now();
+        const uint32_t cycles = us * CyclesPerUs;
+        while (CycleCounter::Since(start) < cycles);
+    }
+
+    /* tickless sleep, at least ms - 1 ms */
+    static inline void DelayMs(uint32_t ms) {
+        SleepUntil(Now() + ms);
+    }
+
+    static void SleepUntil(uint32_t tick) {
+        wakeAt = tick;
+        sleeping = true;
+        while (static_cast<int32_t>(tick - Now()) > 0) {
+            Utils::Sync::__wfi();
+        }
+        sleeping = false;
+    }
+
+private:
+    static inline volatile uint32_t ticks = 0U;
+    /* the running and the next SysTick periods, in ticks */
+    static inline volatile uint32_t period = 1U;
+    static inline volatile uint32_t pending = 1U;
+    static inline volatile uint32_t wakeAt = 0U;
+    static inline volatile bool sleeping = false;
+};
@@ -0,0 +1,78 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstdint>
+#include <tuple>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+#include "vectors.hpp"
+#include "port.hpp"
+#include "pin.hpp"
+
+/* Clock, interrupt, update DMA channel and channel pins (no remap)
+ *   of the general-purpose timers
+ */
+template <typename Regs>
+struct TimerMap;
+
+template <>
+struct TimerMap<TIM2> {
+    using ClockEnable = RCC::APB1ENR::TIM2EN;
+    static constexpr IrqN Irq = IrqN::TIM2;
+    static constexpr uint32_t UpdateDmaChannel = 2U;
+    template <uint32_t ch>
+    using ChannelPin = std::tuple_element_t<ch - 1U, std::tuple<
+        Pin<Port<GPIOA>, 0, PinMode::Config>, Pin<Port<GPIOA>, 1, PinMode::Config>,
+        Pin<Port<GPIOA>, 2, PinMode::Config>, Pin<Port<GPIOA>, 3, PinMode::Config>>>;
+};
+
+template <>
+struct TimerMap<TIM3> {
+    using ClockEnable = RCC::APB1ENR::TIM3EN;
+    static constexpr IrqN Irq = IrqN::TIM3;
+    static constexpr uint32_t UpdateDmaChannel = 3U;
+    template <uint32_t ch>
+    using ChannelPin = std::tuple_element_t<ch - 1U, std::tuple<
+        Pin<Port<GPIOA>, 6, PinMode::Config>, Pin<Port<GPIOA>, 7, PinMode::Config>,
+        Pin<Port<GPIOB>, 0, PinMode::Config>, Pin<Port<GPIOB>, 1, PinMode::Config>>>;
+};
+
+template <>
+struct TimerMap<TIM4> {
+    using ClockEnable = RCC::APB1ENR::TIM4EN;
+    static constexpr IrqN Irq = IrqN::TIM4;
+    static constexpr uint32_t UpdateDmaChannel = 7U;
+    template <uint32_t ch>
+    using ChannelPin = std::tuple_element_t<ch - 1U, std::tuple<
+        Pin<Port<GPIOB>, 6, PinMode::Config>, Pin<Port<GPIOB>, 7, PinMode::Config>,
+        Pin<Port<GPIOB>, 8, PinMode::Config>, Pin<Port<GPIOB>, 9, PinMode::Config>>>;
+};
+
+/* template for TimerRate class
+ *
+ * PSC and ARR of the update rate, computed at compile time: the smallest
+ *   prescaler, so the period has the finest resolution. A rate with more
+ *   than 1% error is a compilation error.
+ *
+ * Clock    - ClockConfig from clock.hpp, TIM2..TIM4 are on APB1
+ * rateHz   - update events per second
+ */
+template <typename Clock, uint32_t rateHz>
+struct TimerRate {
+    static_assert(rateHz > 0U && rateHz <= Clock::TimClk1 / 2U,
+                  "The rate is out of range");
+
+    /* timer clock cycles per update */
+    static constexpr uint32_t Cycles = (Clock::TimClk1 + rateHz / 2U) / rateHz;
+    static constexpr uint32_t Psc = (Cycles - 1U) / 0x10000U;
+    static constexpr uint32_t Arr = (Cycles + (Psc + 1U) / 2U) / (Psc + 1U) - 1U;
+    static constexpr uint32_t ActualCycles = (Psc + 1U) * (Arr + 1U);
+    static constexpr uint32_t ActualHz = Clock::TimClk1 / ActualCycles;
+
+    static_assert(Psc <= 0xFFFFU, "The rate is too low");
+    static_assert((ActualCycles > Cycles ? ActualCycles - Cycles :
+                                           Cycles - ActualCycles) * 100U <= Cycles,
+                  "The rate error is more than 1%");
+};
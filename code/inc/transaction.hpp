@@ -0,0 +1,151 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "register.hpp"
+
+/* Transaction
+ *
+ * Like RegisterFieldSet, but the FieldValues may belong to any registers of
+ *   any peripherals. The values are grouped by register at compile time and
+ *   every touched register is written once, in address order:
+ *    - a single store if the values cover the whole register
+ *      (or if the register is write-only, one-to-set, one-to-clear),
+ *    - a read-modify-write otherwise.
+ *
+ * The registers are written in address order, not in the order of Values.
+ *   If one write depends on another (a clock must be enabled before the
+ *   peripheral is configured), use separate transactions.
+ *
+ * Values - FieldValues
+ *
+ * Example:
+ *   Transaction<
+ *       GPIOA::CRL::CRL0::OutPP50MHz,
+ *       GPIOA::CRH::CRH7::InFloat,
+ *       GPIOA::CRL::CRL1::OutPP2MHz
+ *   >::Set();      // one RMW of CRL, one RMW of CRH
+ */
+template <typename... Values>
+class Transaction {
+public:
+    /* Sync - concurrency policy of the read-modify-writes, see sync.hpp */
+    template <typename Sync = Utils::Sync::None>
+    static void Set() {
+        CheckMode<RegisterMode::Write>();
+
+        SetRegisters<Sync>(std::make_index_sequence<MakePlan().count>{});
+    }
+
+    static bool IsSet() {
+        CheckMode<RegisterMode::Read>();
+
+        return IsSetRegisters(std::make_index_sequence<MakePlan().count>{});
+    }
+
+private:
+    static constexpr size_t valuesNum = sizeof...(Values);
+    static_assert(valuesNum > 0U, "Transaction cannot be empty");
+
+    template <size_t i>
+    using ValueAt = std::tuple_element_t<i, std::tuple<Values...>>;
+
+    /* touched registers sorted by address, and the first value of each */
+    struct Plan {
+        size_t count = 0;
+        uintptr_t address[valuesNum] = {};
+        size_t first[valuesNum] = {};
+    };
+
+    static constexpr Plan MakePlan() {
+        constexpr uintptr_t addresses[] = {Values::Register::Address...};
+
+        Plan plan;
+        for (size_t i = 0; i < valuesNum; ++i) {
+            size_t pos = 0;
+            while (pos < plan.count && plan.address[pos] < addresses[i]) {
+                ++pos;
+            }
+            if (pos < plan.count && plan.address[pos] == addresses[i]) {
+                continue;
+            }
+            for (size_t j = plan.count; j > pos; --j) {
+                plan.address[j] = plan.address[j - 1];
+                plan.first[j] = plan.first[j - 1];
+            }
+            plan.address[pos] = addresses[i];
+            plan.first[pos] = i;
+            ++plan.count;
+        }
+        return plan;
+    }
+
+    template <uintptr_t address>
+    static constexpr uint32_t GetMask() {
+        return ((Values::Register::Address == address ?
+                 static_cast<uint32_t>(Values::Mask) << Values::Offset : 0U) | ...);
+    }
+
+    template <uintptr_t address>
+    static constexpr uint32_t GetValue() {
+        return ((Values::Register::Address == address ?
+                 static_cast<uint32_t>(Values::Value) << Values::Offset : 0U) | ...);
+    }
+
+    /* the sum of the field masks is their union only if they don't overlap */
+    template <uintptr_t address>
+    static constexpr bool IsOverlapped() {
+        const uint64_t sum = ((Values::Register::Address == address ?
+            static_cast<uint64_t>(static_cast<uint32_t>(Values::Mask) <<
+                                  Values::Offset) : 0U) + ...);
+        return sum != GetMask<address>();
+    }
+
+    template <size_t k>
+    using RegisterAt = typename ValueAt<MakePlan().first[k]>::Register;
+
+    template <typename Sync, size_t k>
+    static inline void SetRegister() {
+        using Reg = RegisterAt<k>;
+        using Type = typename Reg::Type;
+        static_assert(!IsOverlapped<Reg::Address>(),
+                      "Two values are written to the same field");
+
+        Reg::template SetMasked<Sync>(
+            static_cast<Type>(GetMask<Reg::Address>()),
+            static_cast<Type>(GetValue<Reg::Address>())
+        );
+    }
+
+    template <typename Sync, size_t... K>
+    static inline void SetRegisters(std::index_sequence<K...>) {
+        (SetRegister<Sync, K>(), ...);
+    }
+
+    template <size_t k>
+    static inline bool IsSetRegister() {
+        using Reg = RegisterAt<k>;
+        using Type = typename Reg::Type;
+
+        const Type regValue = Reg::Bus::template Load<Type>(Reg::Address);
+        return (regValue & static_cast<Type>(GetMask<Reg::Address>())) ==
+               static_cast<Type>(GetValue<Reg::Address>());
+    }
+
+    template <size_t... K>
+    static inline bool IsSetRegisters(std::index_sequence<K...>) {
+        return (IsSetRegister<K>() && ...);
+    }
+
+    /* Check the mode of every value, instead of SFINAE */
+    template <typename T>
+    static constexpr void CheckMode() {
+        static_assert((std::is_base_of_v<T, typename Values::Access> && ...));
+    }
+};
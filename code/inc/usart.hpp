@@ -0,0 +1,253 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+#include "port.hpp"
+#include "pin.hpp"
+#include "dma.hpp"
+#include "nvic.hpp"
+#include "ring_buffer.hpp"
+#include "sync.hpp"
+
+/* DMA channels, pins, clock and interrupt of the USARTs (no remap) */
+template <typename Regs>
+struct UsartMap;
+
+template <>
+struct UsartMap<USART1> {
+    using ClockEnable = RCC::APB2ENR::USART1EN;
+    static constexpr bool IsApb2 = true;
+    static constexpr IrqN Irq = IrqN::USART1;
+    static constexpr uint32_t TxChannel = 4U;
+    static constexpr uint32_t RxChannel = 5U;
+    using TxPin = Pin<Port<GPIOA>, 9,  PinMode::Config>;
+    using RxPin = Pin<Port<GPIOA>, 10, PinMode::Config>;
+};
+
+template <>
+struct UsartMap<USART2> {
+    using ClockEnable = RCC::APB1ENR::USART2EN;
+    static constexpr bool IsApb2 = false;
+    static constexpr IrqN Irq = IrqN::USART2;
+    static constexpr uint32_t TxChannel = 7U;
+    static constexpr uint32_t RxChannel = 6U;
+    using TxPin = Pin<Port<GPIOA>, 2, PinMode::Config>;
+    using RxPin = Pin<Port<GPIOA>, 3, PinMode::Config>;
+};
+
+template <>
+struct UsartMap<USART3> {
+    using ClockEnable = RCC::APB1ENR::USART3EN;
+    static constexpr bool IsApb2 = false;
+    static constexpr IrqN Irq = IrqN::USART3;
+    static constexpr uint32_t TxChannel = 2U;
+    static constexpr uint32_t RxChannel = 3U;
+    using TxPin = Pin<Port<GPIOB>, 10, PinMode::Config>;
+    using RxPin = Pin<Port<GPIOB>, 11, PinMode::Config>;
+};
+
+/* template for UsartDma class
+ *
+ * 8N1 USART, both directions by DMA:
+ *  - TX sends the caller's buffers without copying. One buffer is in flight
+ *    and one more may be queued, the next one starts from the DMA interrupt
+ *    with no gap. A buffer must stay untouched until it is sent, and be
+ *    up to TxSizeMax bytes (16-bit CNDTR), Write rejects a larger one.
+ *  - RX runs forever into a circular buffer. The half, full and idle line
+ *    interrupts publish the DMA position, the main loop reads the received
+ *    bytes in place, like SpscRing.
+ *
+ * The baud divisor is computed from the bus clock at compile time, a rate
+ *   with more than 2% error is a compilation error.
+ *
+ * The handlers must be bound in the vector table, and the USART and the RX
+ *   channel interrupts must have the same priority.
+ *
+ * Regs     - USART1, USART2, USART3 from regs_f103.hpp
+ * Clock    - ClockConfig from clock.hpp
+ * baud     - bits per second
+ * rxSize   - RX buffer, power of two
+ *
+ * Example:
+ *   using Serial = UsartDma<USART1, SystemClock, 115'200>;
+ *   IrqHandler<Serial::Irq,      Serial::OnUsartIrq>,
+ *   IrqHandler<Serial::TxDmaIrq, Serial::OnTxDmaIrq>,
+ *   IrqHandler<Serial::RxDmaIrq, Serial::OnRxDmaIrq>
+ *
+ *   Serial::Init();
+ *   Serial::Write(msg, sizeof(msg));
+ *   const auto rx = Serial::ReadSpan();
+ *   Parse(rx.data, rx.size);
+ *   Serial::Consume(rx.size);
+ */
+template <typename Regs, typename Clock, uint32_t baud, size_t rxSize = 256U>
+class UsartDma {
+    using Map = UsartMap<Regs>;
+    using TxDma = DmaChannel<Map::TxChannel>;
+    using RxDma = DmaChannel<Map::RxChannel>;
+
+public:
+    static constexpr uint32_t PClk = Map::IsApb2 ? Clock::PClk2 : Clock::PClk1;
+    /* USARTDIV * 16, rounded */
+    static constexpr uint32_t Brr = (PClk + baud / 2U) / baud;
+    static constexpr uint32_t ActualBaud = PClk / Brr;
+
+    static_assert(Brr >= 16U && Brr <= 0xFFFFU, "The baud rate is out of range");
+    static_assert((ActualBaud > baud ? ActualBaud - baud : baud - ActualBaud) * 50U <= baud,
+                  "The baud rate error is more than 2%");
+    static_assert(rxSize >= 2U && rxSize <= 0xFFFFU &&
+                  (rxSize & (rxSize - 1U)) == 0U,
+                  "RX buffer must be a power of two, up to 32 KiB");
+
+    /* one DMA transfer */
+    static constexpr size_t TxSizeMax = 0xFFFFU;
+
+    static constexpr IrqN Irq = Map::Irq;
+    static constexpr IrqN TxDmaIrq = TxDma::Irq;
+    static constexpr IrqN RxDmaIrq = RxDma::Irq;
+
+    static void Init() {
+        RCC::AHBENR::DMA1EN::BitBand::Set();
+        Map::ClockEnable::BitBand::Set();
+
+        Map::TxPin::ConfigAlternate();
+        Map::RxPin::template ConfigInput<Map::RxPin::InputMode::PullUp>();
+
+        TxDma::template Configure<
+            typename TxDma::CCR::DIR::FromMemory,
+            typename TxDma::CCR::MINC::Enable,
+            typename TxDma::CCR::TCIE::Enable
+        >(Regs::DR::Address);
+
+        RxDma::template Configure<
+            typename RxDma::CCR::DIR::FromPeripheral,
+            typename RxDma::CCR::MINC::Enable,
+            typename RxDma::CCR::CIRC::Enable,
+            typename RxDma::CCR::HTIE::Enable,
+            typename RxDma::CCR::TCIE::Enable
+        >(Regs::DR::Address);
+        RxDma::Start(rxBuffer, rxSize);
+
+        Regs::BRR::Set(Brr);
+        Regs::CR3::Set(Regs::CR3::DMAT::Mask | Regs::CR3::DMAR::Mask);
+        Regs::CR1::Set(Regs::CR1::UE::Mask | Regs::CR1::TE::Mask |
+                       Regs::CR1::RE::Mask | Regs::CR1::IDLEIE::Mask);
+
+        Nvic<Irq>::Enable();
+        Nvic<TxDmaIrq>::Enable();
+        Nvic<RxDmaIrq>::Enable();
+    }
+
+    /* TX */
+
+    /* Sends the buffer or queues it behind the one in flight,
+     *   false if both are taken or the buffer is over TxSizeMax
+     */
+    static bool Write(const void *data, size_t size) {
+        if (size == 0U) {
+            return true;
+        }
+        if (size > TxSizeMax) {
+            return false;
+        }
+
+        const uint32_t primask = Utils::Sync::__get_primask();
+        Utils::Sync::__disable_irq();
+
+        bool result = true;
+        if (!txBusy) {
+            txBusy = true;
+            TxDma::Start(data, static_cast<uint32_t>(size));
+        } else if (txNextSize == 0U) {
+            txNext = data;
+            txNextSize = size;
+        } else {
+            result = false;
+        }
+
+        Utils::Sync::__set_primask(primask);
+        return result;
+    }
+
+    /* until the DMA is done with all the buffers,
+       the last byte may still be on the line then */
+    static inline bool IsWriting() {
+        return txBusy;
+    }
+
+    /* RX */
+
+    /* the received bytes up to the wrap, released by Consume */
+    static RingSpan<const uint8_t> ReadSpan() {
+        const uint32_t used = rxHead.Load() - rxTail;
+        const uint32_t pos = rxTail & rxMask;
+        return {&rxBuffer[pos], std::min<size_t>(used, rxSize - pos)};
+    }
+
+    static void Consume(size_t n) {
+        rxTail += static_cast<uint32_t>(n);
+    }
+
+    /* the DMA has overwritten unread bytes, Flush() to recover */
+    static bool IsOverrun() {
+        return rxHead.Load() - rxTail > rxSize;
+    }
+
+    static void Flush() {
+        rxTail = rxHead.Load();
+    }
+
+    /* Interrupt handlers */
+
+    static void OnUsartIrq() {
+        if (Regs::SR::Get() & Regs::SR::IDLE::Mask) {
+            /* IDLE is cleared by the read of SR and then DR */
+            static_cast<void>(Regs::DR::Get());
+            UpdateRx();
+        }
+    }
+
+    static void OnTxDmaIrq() {
+        TxDma::ClearFlags(TxDma::Flags::GIF);
+        TxDma::Stop();
+
+        if (txNextSize != 0U) {
+            TxDma::Start(txNext, static_cast<uint32_t>(txNextSize));
+            txNextSize = 0U;
+        } else {
+            txBusy = false;
+        }
+    }
+
+    static void OnRxDmaIrq() {
+        RxDma::ClearFlags(RxDma::Flags::GIF);
+        UpdateRx();
+    }
+
+private:
+    static constexpr uint32_t rxMask = static_cast<uint32_t>(rxSize - 1U);
+
+    /* the DMA position is sampled at least twice per lap (half, full),
+       so the distance from the previous one is never ambiguous */
+    static void UpdateRx() {
+        const uint32_t pos = (rxSize - RxDma::Remaining()) & rxMask;
+        const uint32_t written = (pos - rxLastPos) & rxMask;
+        rxLastPos = pos;
+        rxHead.Store(rxHead.Load() + written);
+    }
+
+    static inline volatile bool txBusy = false;
+    static inline const void *volatile txNext = nullptr;
+    static inline volatile size_t txNextSize = 0U;
+
+    static inline uint8_t rxBuffer[rxSize];
+    static inline uint32_t rxLastPos = 0U;          /* interrupts only */
+    static inline Utils::Sync::SharedIndex rxHead;  /* written by interrupts */
+    static inline uint32_t rxTail = 0U;             /* main loop only */
+};
@@ -13,39 +13,109 @@ namespace Utils {
 namespace Utils {
 namespace Sync {
 
-    uint32_t __ldrex(volatile uint32_t *addr);
-    uint32_t __strex(uint32_t val, volatile uint32_t *addr);
-    void __clrex(void);
-
-    template <typename T>
-    class Atomic {
-    public:
-        static void Set(T addr, T mask, T val, T offset) {
-            T prevVal;
-            T newVal;
-            do {
-                prevVal = *reinterpret_cast<volatile T *>(addr);
-                newVal = prevVal;
-                newVal &= ~(mask << (offset));
-                newVal |= (val << (offset));
-            } while (
-                !TryToWrite(reinterpret_cast<volatile T *>(addr),
-                            prevVal,
-                            newVal)
-            );
-        }
-
-    private:
-        static bool TryToWrite(volatile T *ptr, T oldVal, T newVal) {
-            if (__ldrex(ptr) == static_cast<uint32_t>(oldVal)) {
-                return (0 == __strex(static_cast<uint32_t>(newVal),
-                                     static_cast<volatile uint32_t *>(ptr))
-                );
-            }
-            __clrex();
-            return false;
-        }
-    };
+/* Cortex-M3 intrinsics
+ *
+ * Inlined, so the compiler can schedule them with the surrounding code.
+ * On the host (simulated bus) they are plain accesses and no-ops.
+ */
+#if defined(__arm__)
+
+    __attribute__((always_inline))
+    inline uint32_t __ldrex(volatile uint32_t *addr) {
+        uint32_t res;
+        __asm__ volatile("ldrex %0, [%1]"
+                         : "=r"(res)
+                         : "r"(addr)
+                         : "memory");
+        return res;
+    }
+
+    __attribute__((always_inline))
+    inline uint32_t __strex(uint32_t val, volatile uint32_t *addr) {
+        uint32_t res;
+        __asm__ volatile("strex %0, %2, [%1]"
+                         : "=&r"(res)
+                         : "r"(addr), "r"(val)
+                         : "memory");
+        return res;
+    }
+
+    __attribute__((always_inline))
+    inline void __clrex(void) {
+        __asm__ volatile ("clrex" ::: "memory");
+    }
+
+    __attribute__((always_inline))
+    inline uint32_t __get_primask(void) {
+        uint32_t res;
+        __asm__ volatile ("mrs %0, primask" : "=r"(res));
+        return res;
+    }
+
+    __attribute__((always_inline))
+    inline void __set_primask(uint32_t val) {
+        __asm__ volatile ("msr primask, %0" :: "r"(val) : "memory");
+    }
+
+    __attribute__((always_inline))
+    inline void __disable_irq(void) {
+        __asm__ volatile ("cpsid i" ::: "memory");
+    }
+
+    /* data memory barrier, orders the accesses for DMA and other contexts */
+    __attribute__((always_inline))
+    inline void __dmb(void) {
+        __asm__ volatile ("dmb" ::: "memory");
+    }
+
+    /* data synchronization barrier, completes the accesses before going on */
+    __attribute__((always_inline))
+    inline void __dsb(void) {
+        __asm__ volatile ("dsb" ::: "memory");
+    }
+
+    /* sleep until an interrupt */
+    __attribute__((always_inline))
+    inline void __wfi(void) {
+        __asm__ volatile ("wfi" ::: "memory");
+    }
+
+#else
+
+    inline uint32_t __ldrex(volatile uint32_t *addr) {
+        return *addr;
+    }
+
+    inline uint32_t __strex(uint32_t val, volatile uint32_t *addr) {
+        *addr = val;
+        return 0U;
+    }
+
+    inline void __clrex(void)
+    {}
+
+    inline uint32_t __get_primask(void) {
+        return 0U;
+    }
+
+    inline void __set_primask(uint32_t)
+    {}
+
+    inline void __disable_irq(void)
+    {}
+
+    inline void __dmb(void) {
+        __asm__ volatile ("" ::: "memory");
+    }
+
+    inline void __dsb(void) {
+        __asm__ volatile ("" ::: "memory");
+    }
+
+    inline void __wfi(void)
+    {}
+
+#endif
 
 } /* namespace Sync */
-} /* namespace Utils */
\ No newline at end of file
+} /* namespace Utils */
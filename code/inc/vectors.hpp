@@ -0,0 +1,177 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/* Exceptions and interrupts of STM32F103 (Medium Density), as in CMSIS
+ *
+ * Negative values are the core exceptions, the others are the IRQ numbers.
+ */
+enum class IrqN : int32_t {
+    NonMaskableInt      = -14,
+    HardFault           = -13,
+    MemoryManagement    = -12,
+    BusFault            = -11,
+    UsageFault          = -10,
+    SVCall              = -5,
+    DebugMonitor        = -4,
+    PendSV              = -2,
+    SysTick             = -1,
+    WWDG                = 0,
+    PVD                 = 1,
+    TAMPER              = 2,
+    RTC                 = 3,
+    FLASH               = 4,
+    RCC                 = 5,
+    EXTI0               = 6,
+    EXTI1               = 7,
+    EXTI2               = 8,
+    EXTI3               = 9,
+    EXTI4               = 10,
+    DMA1_Channel1       = 11,
+    DMA1_Channel2       = 12,
+    DMA1_Channel3       = 13,
+    DMA1_Channel4       = 14,
+    DMA1_Channel5       = 15,
+    DMA1_Channel6       = 16,
+    DMA1_Channel7       = 17,
+    ADC1_2              = 18,
+    USB_HP_CAN1_TX      = 19,
+    USB_LP_CAN1_RX0     = 20,
+    CAN1_RX1            = 21,
+    CAN1_SCE            = 22,
+    EXTI9_5             = 23,
+    TIM1_BRK            = 24,
+    TIM1_UP             = 25,
+    TIM1_TRG_COM        = 26,
+    TIM1_CC             = 27,
+    TIM2                = 28,
+    TIM3                = 29,
+    TIM4                = 30,
+    I2C1_EV             = 31,
+    I2C1_ER             = 32,
+    I2C2_EV             = 33,
+    I2C2_ER             = 34,
+    SPI1                = 35,
+    SPI2                = 36,
+    USART1              = 37,
+    USART2              = 38,
+    USART3              = 39,
+    EXTI15_10           = 40,
+    RTC_Alarm           = 41,
+    USBWakeUp           = 42,
+};
+
+/* the list of constants from linker */
+extern uintptr_t _estack;    /* top of stack */
+
+/* from the startup file */
+extern "C" void Reset_Handler(void);
+void DummyIrqHandler();
+void HardfaultHandler();
+
+
+using irqFunc = void(*)();
+
+struct irqVectorItem {
+    constexpr irqVectorItem(irqFunc f) : func(f)
+    {}
+    constexpr irqVectorItem(uintptr_t *p) : ptr(p)
+    {}
+
+    union {
+        irqFunc     func;
+        uintptr_t*  ptr;
+    };
+};
+
+/* Handler binding
+ *
+ * irq      - the exception or interrupt
+ * handler  - the function, called directly by the hardware
+ */
+template <IrqN irq, irqFunc handler>
+struct IrqHandler {
+    static constexpr IrqN Irq = irq;
+    static constexpr irqFunc Func = handler;
+};
+
+/* Vector table
+ *
+ * Generated at compile time from the handler bindings, every entry is
+ *   the address of the handler itself: no trampoline, no dispatch table.
+ *   Unbound entries point to DummyIrqHandler (HardfaultHandler for
+ *   the hard fault).
+ *
+ * Handlers - IrqHandlers
+ *
+ * The application places the table into the .isr_vector section once:
+ *   using Vectors = VectorTable<
+ *       IrqHandler<IrqN::EXTI1, ButtonIsr>
+ *   >;
+ *   extern "C" __attribute__((section(".isr_vector"), used))
+ *   const Vectors::Type vectorTable = Vectors::Make();
+ */
+template <typename... Handlers>
+struct VectorTable {
+    /* 16 core entries, 43 IRQs, 7 reserved, BootRAM at 0x108 */
+    static constexpr size_t Size = 67U;
+    using Type = std::array<irqVectorItem, Size>;
+
+    static constexpr irqFunc Get(IrqN irq) {
+        irqFunc func = (irq == IrqN::HardFault) ? HardfaultHandler :
+                                                  DummyIrqHandler;
+        ((Handlers::Irq == irq ? (func = Handlers::Func, 0) : 0), ...);
+        return func;
+    }
+
+private:
+    static constexpr size_t coreEntries = 16U;
+    static constexpr size_t irqEntries = 43U;
+
+    template <typename T>
+    static constexpr size_t countOf = ((T::Irq == Handlers::Irq) + ...);
+    static_assert(((countOf<Handlers> == 1U) && ...),
+                  "An interrupt has two handlers");
+    static_assert(((Handlers::Func != nullptr) && ...),
+                  "A handler cannot be null");
+
+    static constexpr bool IsReserved(size_t i) {
+        return (i >= 7U && i <= 10U) || (i == 13U) ||
+               (i >= coreEntries + irqEntries && i < Size - 1U);
+    }
+
+    static constexpr irqVectorItem Entry(size_t i) {
+        if (i == 0U) {
+            return irqVectorItem(&_estack);
+        }
+        if (i == 1U) {
+            return irqVectorItem(Reset_Handler);
+        }
+        if (IsReserved(i)) {
+            return irqVectorItem(static_cast<irqFunc>(nullptr));
+        }
+        /* BootRAM */
+        if (i == Size - 1U) {
+            return irqVectorItem(DummyIrqHandler);
+        }
+        return irqVectorItem(Get(static_cast<IrqN>(
+            static_cast<int32_t>(i) - static_cast<int32_t>(coreEntries))));
+    }
+
+    template <size_t... I>
+    static constexpr Type Make(std::index_sequence<I...>) {
+        return Type{{Entry(I)...}};
+    }
+
+public:
+    static constexpr Type Make() {
+        return Make(std::make_index_sequence<Size>{});
+    }
+};
+
+static_assert(sizeof(irqVectorItem) == sizeof(uintptr_t));
@@ -0,0 +1,126 @@
+/* 2021 Nikolai Chizhov */
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "register.hpp"
+#include "regs_f103.hpp"
+#include "pin_group.hpp"
+#include "timer.hpp"
+#include "dma.hpp"
+
+/* template for Waveform class
+ *
+ * Parallel output of precomputed pin states with no CPU involvement: every
+ *   update event of the timer makes the DMA copy the next BSRR word to the
+ *   port. The states are PinGroup values (bit N - the N-th pin), compiled to
+ *   BSRR words at compile time or by Compile() at run time.
+ *
+ * All the pins must be on one port and configured as outputs. The DMA needs
+ *   a few bus cycles per word, so the rate is limited to a few MHz.
+ *
+ * Group    - PinGroup on one port
+ * Timer    - TIM2, TIM3, TIM4, the update DMA request drives the output
+ * Clock    - ClockConfig from clock.hpp
+ * rateHz   - states per second
+ *
+ * Example:
+ *   using Bus = Waveform<PinGroup<D0, D1, Clk>, TIM2, SystemClock, 1'000'000>;
+ *   static constexpr auto frame = Bus::Sequence<0b001, 0b101, 0b010, 0b110>;
+ *   Bus::Init();
+ *   Bus::Play(frame.data(), frame.size());
+ */
+template <typename Group, typename Timer, typename Clock, uint32_t rateHz>
+class Waveform {
+    using PortType = typename Group::PortType;
+    using Rate = TimerRate<Clock, rateHz>;
+    using Map = TimerMap<Timer>;
+    using Dma = DmaChannel<Map::UpdateDmaChannel>;
+
+    static_assert(Group::PortCount() == 1U, "All the pins must be on one port");
+
+public:
+    using Word = uint32_t;
+
+    static constexpr uint32_t ActualHz = Rate::ActualHz;
+
+    static constexpr Word Compile(uint32_t state) {
+        return Group::template Bsrr<PortType>(state);
+    }
+
+    static void Compile(const uint32_t *states, Word *words, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            words[i] = Compile(states[i]);
+        }
+    }
+
+    /* the words of the states, in flash */
+    template <uint32_t... states>
+    static constexpr std::array<Word, sizeof...(states)> Sequence = {{
+        Compile(states)...
+    }};
+
+    /* the timer runs at the rate, the output is idle */
+    static void Init() {
+        RCC::AHBENR::DMA1EN::BitBand::Set();
+        Map::ClockEnable::BitBand::Set();
+
+        Timer::CR1::Set(0U);
+        Timer::PSC::Set(Rate::Psc);
+        Timer::ARR::Set(Rate::Arr);
+        /* load PSC before the DMA request is enabled */
+        Timer::EGR::Set(Timer::EGR::UG);
+        Timer::SR::Set(0U);
+        Timer::DIER::Set(Timer::DIER::UDE::Mask);
+    }
+
+    /* once, the last state stays on the pins */
+    static void Play(const Word *words, size_t n) {
+        Start<false>(words, n);
+    }
+
+    /* forever, until Stop() */
+    static void Loop(const Word *words, size_t n) {
+        Start<true>(words, n);
+    }
+
+    static inline bool IsPlaying() {
+        return Dma::Remaining() != 0U;
+    }
+
+    static void Stop() {
+        Timer::CR1::CEN::BitBand::Reset();
+        Dma::Stop();
+    }
+
+private:
+    template <bool circular>
+    static void Start(const Word *words, size_t n) {
+        assert(n > 0U && n <= 0xFFFFU);
+
+        Stop();
+
+        using CCR = typename Dma::CCR;
+        if constexpr (circular) {
+            Dma::template Configure<
+                typename CCR::DIR::FromMemory, typename CCR::MINC::Enable,
+                typename CCR::MSIZE::Bits32, typename CCR::PSIZE::Bits32,
+                typename CCR::PL::VeryHigh, typename CCR::CIRC::Enable
+            >(PortType::Regs::BSRR::Address);
+        } else {
+            Dma::template Configure<
+                typename CCR::DIR::FromMemory, typename CCR::MINC::Enable,
+                typename CCR::MSIZE::Bits32, typename CCR::PSIZE::Bits32,
+                typename CCR::PL::VeryHigh
+            >(PortType::Regs::BSRR::Address);
+        }
+        Dma::Start(words, static_cast<uint32_t>(n));
+
+        Timer::CNT::Set(0U);
+        Timer::CR1::CEN::BitBand::Set();
+    }
+};
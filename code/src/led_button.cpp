@@ -6,6 +6,19 @@
 #include "regs_f103.hpp"
 #include "port.hpp"
 #include "pin.hpp"
+#include "pin_group.hpp"
+#include "transaction.hpp"
+#include "board.hpp"
+#include "vectors.hpp"
+#include "exti.hpp"
+#include "clock.hpp"
+#include "profiler.hpp"
+#include "timebase.hpp"
+#include "usart.hpp"
+#include "waveform.hpp"
+#include "pwm.hpp"
+#include "adc.hpp"
+#include "ramfunc.hpp"
 
 /* Button.
  * I use 2 buttons for demo purporses. For example:
@@ -30,18 +43,32 @@ static inline void example_pin() {
     Led::Reset();               /* turn the led off */
     Led::Get();                 /* is the led on? */
     Led::ConfigInput();         /* doesn't make sense, but you can do this */
+    /* the EXTI pins are in the one ExtiSetup, see mcu_low_level_init */
 
     /* 3) but you cannot change the button's state */
     // Button::Reset();         /* comp. error, you cannot modify Read-only pins */
     // Button::ConfigOutput();  /* comp. error, you cannot config Read-only pins */
 }
 
+static inline void example_pin_group() {
+    /* several pins, one BSRR store per port */
+    using Leds = PinGroup<
+        Pin<Port<GPIOA>, 0, PinMode::Write>,
+        Pin<Port<GPIOB>, 5, PinMode::Write>,
+        Pin<Port<GPIOA>, 3, PinMode::Write>
+    >;
+    Leds::Set();                /* GPIOA::BSRR = 0x09, GPIOB::BSRR = 0x20 */
+    Leds::Write(0b010);         /* PB5 high, PA0 and PA3 low */
+    Leds::Toggle();             /* one ODR load + one BSRR store per port */
+}
+
 static inline void example_register() {
     /* Registers, CMSIS-like but protected */
     GPIOB::CRL::CRL0::OutPP50MHz::Set();    /* Init as Out-PP-50MHz */
     GPIOB::ODR::ODR0::High::Set();          /* Set logic 1 using ODR */
     GPIOB::BSRR::BR0::Low::Set();           /* Set logic 0 using BSR */
     GPIOB::ODR::Set(0x01);                  /* Wrire to the register */
+    GPIOB::ODR::ODR0::BitBand::Reset();     /* Single store via bit-band */
     // GPIOB::BSRR::BS1::Get();             /* comp. error, BSRR is write-only */
     // GPIOB::IDR::Set(0x01);               /* comp. error, IDR is read-only */
 
@@ -52,6 +79,16 @@ static inline void example_register() {
         GPIOA::CRL::CRL7::InFloat
     >::Set();
 
+    /* or a transaction to set values of several registers,
+     * one access per register: RMW of CRL, RMW of CRH, a store to BSRR
+     */
+    Transaction<
+        GPIOA::CRL::CRL0::OutPP50MHz,
+        GPIOA::CRH::CRH7::InFloat,
+        GPIOA::CRL::CRL1::OutPP2MHz,
+        GPIOA::BSRR::BS0::High
+    >::Set();
+
     /* compilation error.
      * you cannot set a value from another port (GPIOB)
      */
@@ -70,9 +107,9 @@ static inline void example_register() {
 }
 
 
-static inline void mcu_low_level_init() {
-    /* Turn GPIOA clock ON */
-    RCC::APB2ENR::GPIOAEN::Enable::Set();
+static inline void example_init() {
+    /* Turn GPIOA clock ON, a single bit-band store */
+    RCC::APB2ENR::GPIOAEN::BitBand::Set();
 
     /* Led: config and switch on */
     Led::ConfigOutput(); 	    /* GPIOA::CRL::CRL0::OutPP50MHz::Set(); */
@@ -83,15 +120,128 @@ static inline void mcu_low_level_init() {
     ButtonCfg::ConfigInput<ButtonCfg::InputMode::PullDown>();
 }
 
+/* The same as example_init(), but computed at compile time:
+ *   RMW of RCC::APB2ENR, then GPIOA::ODR = 0x01, GPIOA::CRL = 0x44444483
+ */
+using ButtonCfg = Pin<ButtonPort, btnPinNum, PinMode::Config>;
+using BoardCfg = Board<
+    PinConfig<Led,       PinSetup::OutputHigh>,
+    PinConfig<ButtonCfg, PinSetup::InputPullDown>
+>;
+
+/* 8 MHz crystal, PLL x9 */
+using SystemClock = ClockConfig<ClockSource::Hse<8'000'000>, 72'000'000>;
+
+/* 1 ms SysTick */
+using SystemTime = Timebase<SystemClock>;
+
+/* Telemetry: PA9 - TX, PA10 - RX */
+using Serial = UsartDma<USART1, SystemClock, 115'200>;
+
+static inline void example_waveform() {
+    /* 4-bit parallel output at 1 MHz: TIM2 update -> DMA -> GPIOB::BSRR */
+    using Lines = PinGroup<
+        Pin<Port<GPIOB>, 12, PinMode::Write>,
+        Pin<Port<GPIOB>, 13, PinMode::Write>,
+        Pin<Port<GPIOB>, 14, PinMode::Write>,
+        Pin<Port<GPIOB>, 15, PinMode::Write>
+    >;
+    using Bus = Waveform<Lines, TIM2, SystemClock, 1'000'000>;
+
+    /* BSRR words in flash, computed at compile time */
+    static constexpr auto frame = Bus::Sequence<0b0001, 0b0010, 0b0100, 0b1000>;
+
+    Bus::Init();
+    Bus::Loop(frame.data(), frame.size());  /* the CPU is free from now on */
+}
+
+static inline void example_pwm() {
+    /* the Led pin is TIM2_CH1: 1 kHz, 1000 steps, no CPU after Init */
+    using Dimmer = PwmTimer<TIM2, SystemClock, 1'000, 1'000>;
+    using LedPwm = PwmChannel<Dimmer, 1, Led>;
+
+    Dimmer::Init();
+    LedPwm::Init(LedPwm::Percent(10));
+    LedPwm::SetDuty(750);       /* one preloaded store, from the next period */
+
+    // PwmChannel<Dimmer, 2, Led>::Init();  /* comp. error, PA0 is not CH2 */
+}
+
+/* the mean of the first channel of a half of the buffer */
+static volatile uint32_t potLevel = 0;
+static void OnSamples(const uint16_t *samples, size_t sequences) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < sequences; ++i) {
+        sum += samples[i * 2U];
+    }
+    potLevel = sum / sequences;
+}
+
+static inline void example_adc() {
+    /* PA2, PA3 scanned forever, 2 x 16 scans in a circular DMA buffer */
+    using Inputs = AdcSequence<
+        AdcInput<2, AdcSampleTime::Cycles71_5>,
+        AdcInput<3, AdcSampleTime::Cycles71_5>
+    >;
+    using Sampler = AdcScan<SystemClock, Inputs, 16, OnSamples, OnSamples>;
+    /* + IrqHandler<Sampler::Irq, Sampler::OnDmaIrq> in the vector table */
+
+    Sampler::Init();
+    Sampler::Start();           /* no CPU until a half of the buffer is full */
+}
+
+/* Blink period in ms, updated by the button interrupt */
+static constexpr uint32_t blinkMsMax = 500U;
+static volatile uint32_t blinkMs = blinkMsMax;
+
+/* ISR latency budget, compiled with HWREG_PROFILING only */
+using ButtonIsrPrb = Probe<struct ButtonIsrTag>;
+
+/* runs from SRAM, no flash wait states */
+HWREG_RAMFUNC static void ButtonIsr() {
+    ScopedTimer<ButtonIsrPrb> timer;
+
+    Button::ClearInterrupt();
+    blinkMs = Button::Get() ? blinkMsMax / 4: blinkMsMax;
+}
+
+static inline void mcu_low_level_init() {
+    SystemClock::Apply();
+    SystemTime::Init();
+    Profiler::Init();
+    BoardCfg::Init();
+    Serial::Init();
+
+    /* all the EXTI pins of the application, the button on both edges */
+    ExtiSetup<ExtiConfig<ButtonCfg, ExtiEdge::Both>>::Init();
+}
+
+/* Interrupt handlers, called directly by the hardware */
+using Vectors = VectorTable<
+    IrqHandler<IrqN::SysTick, SystemTime::OnTick>,
+    IrqHandler<Serial::Irq, Serial::OnUsartIrq>,
+    IrqHandler<Serial::TxDmaIrq, Serial::OnTxDmaIrq>,
+    IrqHandler<Serial::RxDmaIrq, Serial::OnRxDmaIrq>,
+    IrqHandler<ExtiLine<btnPinNum>::Irq, ButtonIsr>
+>;
+
+extern "C" __attribute__((section(".isr_vector"), used))
+const Vectors::Type vectorTable = Vectors::Make();
+
 int main() {
     mcu_low_level_init();
 
     while (1) {
-        constexpr uint32_t ticksMax = 200'000;
-        const uint32_t ticks = Button::Get() ? ticksMax / 4: ticksMax;
-
-        for (uint32_t i = 0; i < ticks; ++i);
+        /* the core sleeps between the toggles */
+        SystemTime::DelayMs(blinkMs);
 
         Led::Toggle();
+
+        /* sent from flash by DMA, no copy */
+        static constexpr char msg[] = "toggle\r\n";
+        Serial::Write(msg, sizeof(msg) - 1U);
+
+        /* drop the input */
+        Serial::Consume(Serial::ReadSpan().size);
     };
 }
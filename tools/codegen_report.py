@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+# 2021 Nikolai Chizhov
+
+"""Code generation report
+
+Disassembles the objects of bench/codegen/kernels.cpp and compares every
+tmpl_<kernel> function with its raw_<kernel> reference: instructions, bytes
+and an estimate of Cortex-M3 cycles. A function that calls another one of
+the object (a helper that was not inlined) is counted with its callees.
+
+The cycle estimate is static, every instruction once: 1 cycle, 2 for a
+load or a store, 1 + N for LDM/STM/PUSH/POP, 3 for an unconditional branch
+(1 + pipeline refill), 2 for a conditional one. It tracks the trend, use
+bench/target for the real numbers.
+
+A template function larger or slower than its reference at a strict level
+fails the report.
+
+Usage: codegen_report.py [--objdump PATH] [--strict Og,O2,Os] <level>=<object>...
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+FUNCTION = re.compile(r'^[0-9a-f]+ <(\w+)>:$')
+INSTRUCTION = re.compile(r'^\s*[0-9a-f]+:\t([0-9a-f ]+?)\s*(?:\t(\S+)\s*(.*))?$')
+CALL = re.compile(r'<(\w+)(?:\+0x[0-9a-f]+)?>')
+RELOCATION = re.compile(r'^\s*[0-9a-f]+: R_\w+\s+([\w.]+)')
+
+CONDITIONS = ('eq', 'ne', 'cs', 'cc', 'hs', 'lo', 'mi', 'pl', 'vs', 'vc',
+              'hi', 'ls', 'ge', 'lt', 'gt', 'le')
+
+
+def cycles(mnemonic, operands):
+    op = mnemonic.split('.')[0]
+    if op in ('ldm', 'ldmia', 'ldmdb', 'stm', 'stmia', 'stmdb', 'push', 'pop'):
+        registers = operands[operands.find('{') + 1:operands.find('}')]
+        count = 0
+        for item in registers.split(','):
+            bounds = re.findall(r'\d+', item)
+            count += int(bounds[1]) - int(bounds[0]) + 1 if '-' in item else 1
+        return 1 + count + (3 if 'pc' in registers else 0)
+    if op in ('b', 'bx', 'bl', 'blx'):
+        return 3
+    if op in ('cbz', 'cbnz') or (op[0] == 'b' and op[1:] in CONDITIONS):
+        return 2
+    if op.startswith(('ldr', 'str')):
+        return 2
+    if op in ('sdiv', 'udiv'):
+        return 7
+    return 1
+
+
+class Function:
+    def __init__(self, name):
+        self.name = name
+        self.insns = 0
+        self.bytes = 0
+        self.cycles = 0
+        self.calls = set()
+
+
+def disassemble(objdump, path):
+    out = subprocess.run([objdump, '-dr', path], check=True,
+                         stdout=subprocess.PIPE, universal_newlines=True).stdout
+    functions = {}
+    current = None
+    for line in out.splitlines():
+        match = FUNCTION.match(line)
+        if match:
+            current = functions.setdefault(match.group(1), Function(match.group(1)))
+            continue
+        if current is None:
+            continue
+        # the call of a helper: a relocation against another function
+        match = RELOCATION.match(line)
+        if match:
+            current.calls.add(match.group(1))
+            continue
+        match = INSTRUCTION.match(line)
+        if not match:
+            continue
+        raw, mnemonic, operands = match.groups()
+        current.bytes += len(raw.replace(' ', '')) // 2
+        # a continuation of the previous encoding, or alignment padding
+        if not mnemonic or mnemonic.startswith(('nop', 'data16', 'xchg')):
+            continue
+        # a literal pool: bytes, not instructions
+        if mnemonic.startswith('.'):
+            continue
+        current.insns += 1
+        current.cycles += cycles(mnemonic, operands or '')
+        target = CALL.search(operands or '')
+        if target and target.group(1) != current.name:
+            current.calls.add(target.group(1))
+    return functions
+
+
+def total(functions, name):
+    """the function along with everything it calls in the object"""
+    seen = set()
+    stack = [name]
+    insns = size = cost = 0
+    while stack:
+        f = functions.get(stack.pop())
+        if f is None or f.name in seen:
+            continue
+        seen.add(f.name)
+        insns += f.insns
+        size += f.bytes
+        cost += f.cycles
+        stack.extend(f.calls)
+    return insns, size, cost
+
+
+def main():
+    parser = argparse.ArgumentParser(usage=__doc__)
+    parser.add_argument('--objdump', default='arm-none-eabi-objdump')
+    parser.add_argument('--strict', default='')
+    parser.add_argument('objects', nargs='+')
+    args = parser.parse_args()
+    strict = set(filter(None, args.strict.split(',')))
+
+    failed = []
+    print('%-6s %-20s %15s %15s %15s' % ('level', 'kernel', 'insns', 'bytes', 'cycles'))
+    print('%-6s %-20s %15s %15s %15s' % ('', '', 'tmpl / raw', 'tmpl / raw', 'tmpl / raw'))
+    for item in args.objects:
+        level, path = item.split('=', 1)
+        functions = disassemble(args.objdump, path)
+        kernels = sorted(n[len('tmpl_'):] for n in functions if n.startswith('tmpl_'))
+        for kernel in kernels:
+            tmpl = total(functions, 'tmpl_' + kernel)
+            raw = total(functions, 'raw_' + kernel)
+            worse = tmpl[1] > raw[1] or tmpl[2] > raw[2]
+            mark = ''
+            if worse:
+                mark = ' REGRESSION' if level in strict else ' worse'
+                if level in strict:
+                    failed.append('%s %s' % (level, kernel))
+            print('%-6s %-20s %7u / %-5u %7u / %-5u %7u / %-5u%s'
+                  % (level, kernel, tmpl[0], raw[0], tmpl[1], raw[1],
+                     tmpl[2], raw[2], mark))
+
+    if failed:
+        sys.exit('The register API is behind raw access: ' + ', '.join(failed))
+
+
+if __name__ == '__main__':
+    main()
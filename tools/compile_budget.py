@@ -0,0 +1,41 @@
+#!/usr/bin/env python3
+# 2021 Nikolai Chizhov
+
+"""Compile time budget
+
+Compiles a file with -fsyntax-only a few times and fails when the best time
+is over the budget. The best of several runs is taken, so a busy machine
+doesn't fail the check; a header that got expensive does.
+
+Usage: compile_budget.py <budget ms> <compiler> <file> [compiler flags...]
+"""
+
+import subprocess
+import sys
+import time
+
+RUNS = 5
+
+
+def main():
+    if len(sys.argv) < 4:
+        sys.exit(__doc__)
+    budget = float(sys.argv[1])
+    command = [sys.argv[2], '-fsyntax-only', sys.argv[3]] + sys.argv[4:]
+
+    best = None
+    for _ in range(RUNS):
+        start = time.perf_counter()
+        result = subprocess.run(command)
+        elapsed = (time.perf_counter() - start) * 1000.0
+        if result.returncode != 0:
+            sys.exit('%s: compilation failed' % sys.argv[3])
+        best = elapsed if best is None else min(best, elapsed)
+
+    print('%s: %.0f ms, budget %.0f ms' % (sys.argv[3], best, budget))
+    if best > budget:
+        sys.exit('%s: over the compile time budget' % sys.argv[3])
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+# 2021 Nikolai Chizhov
+
+"""Packed .data image
+
+The firmware is linked twice with HWREG_PACK_DATA. The first link has the
+plain .data image (ld/plain), 'pack' reads it and writes a source file with
+the packed image in the .data_packed section. The second link takes the same
+objects and that file, and puts the packed image where the plain one was
+(ld/packed). Nothing before it moves, so the contents of .data are the same.
+Reset_Handler unpacks it with Startup::Unpack, the format is described in
+code/inc/startup.hpp.
+
+'pack' prints the flash saved and an estimate of the cycles the unpacking
+adds to the boot: 6 cycles per token and per byte out against 10 per 16
+bytes of the burst copy, flash wait states not counted. SyncBench.elf prints
+the measured ones (Startup::DataCycles).
+
+'check' compares the two links: every section at the same address with the
+same size, and the packed image unpacked equal to the plain one.
+
+Usage: pack_data.py [--objdump PATH] [--objcopy PATH] pack <plain.elf> <out.cpp>
+       pack_data.py [--objdump PATH] [--objcopy PATH] check <plain.elf> <packed.elf>
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+# the format of Startup::Unpack
+MATCH = 0x80
+MIN_MATCH = 4
+MAX_MATCH = MIN_MATCH + 0x7F
+MAX_LITERALS = 0x80
+MAX_OFFSET = 0xFFFF
+
+# how many earlier positions of a 4-byte prefix are tried
+CHAIN = 64
+
+SECTION = re.compile(r'^\s*\d+\s+(\S+)\s+([0-9a-f]+)\s+([0-9a-f]+)\s+([0-9a-f]+)\s')
+
+
+def pack(data):
+    """greedy LZ77: the longest match among the last CHAIN candidates"""
+    out = bytearray()
+    literals = bytearray()
+    heads = {}
+    stats = {'literals': 0, 'matches': 0, 'tokens': 0}
+
+    def flush():
+        for start in range(0, len(literals), MAX_LITERALS):
+            run = literals[start:start + MAX_LITERALS]
+            out.append(len(run) - 1)
+            out.extend(run)
+            stats['tokens'] += 1
+        stats['literals'] += len(literals)
+        del literals[:]
+
+    def insert(position):
+        key = bytes(data[position:position + MIN_MATCH])
+        if len(key) == MIN_MATCH:
+            heads.setdefault(key, []).append(position)
+
+    i = 0
+    while i < len(data):
+        best, offset = 0, 0
+        for j in reversed(heads.get(bytes(data[i:i + MIN_MATCH]), [])[-CHAIN:]):
+            if i - j > MAX_OFFSET:
+                break
+            n = 0
+            while n < MAX_MATCH and i + n < len(data) and data[j + n] == data[i + n]:
+                n += 1
+            if n > best:
+                best, offset = n, i - j
+            if n == MAX_MATCH:
+                break
+
+        if best >= MIN_MATCH:
+            flush()
+            out.append(MATCH | (best - MIN_MATCH))
+            out.extend((offset & 0xFF, offset >> 8))
+            stats['matches'] += 1
+            stats['tokens'] += 1
+            for k in range(i, i + best):
+                insert(k)
+            i += best
+        else:
+            literals.append(data[i])
+            insert(i)
+            i += 1
+    flush()
+    return bytes(out), stats
+
+
+def unpack(packed, size):
+    """the reference of Startup::Unpack"""
+    out = bytearray()
+    s = 0
+    while len(out) < size:
+        token = packed[s]
+        s += 1
+        if token < MATCH:
+            out.extend(packed[s:s + token + 1])
+            s += token + 1
+        else:
+            offset = packed[s] | (packed[s + 1] << 8)
+            s += 2
+            for _ in range((token & ~MATCH) + MIN_MATCH):
+                out.append(out[-offset])
+    return bytes(out)
+
+
+def sections(objdump, elf):
+    """name: (size, vma, lma) of the sections in the memory map, not debug info"""
+    out = subprocess.run([objdump, '-h', elf], check=True,
+                         stdout=subprocess.PIPE, universal_newlines=True).stdout
+    result = {}
+    for line in out.splitlines():
+        match = SECTION.match(line)
+        if match:
+            name, size, vma, lma = match.groups()
+            if int(vma, 16) != 0:
+                result[name] = (int(size, 16), int(vma, 16), int(lma, 16))
+    return result
+
+
+def contents(objcopy, elf, name):
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'section.bin')
+        subprocess.run([objcopy, '-O', 'binary', '-j', name, elf, path], check=True)
+        with open(path, 'rb') as f:
+            return f.read()
+
+
+def write_source(path, packed, size):
+    lines = [
+        '/* Generated by tools/pack_data.py, do not edit */',
+        '',
+        '/* the .data image packed: %u bytes, %u unpacked */' % (len(packed), size),
+        '',
+        '#include <cstdint>',
+        '',
+    ]
+    if packed:
+        lines.append('extern "C" __attribute__((section(".data_packed"), used))')
+        lines.append('const uint8_t _data_packed[%u] = {' % len(packed))
+        for start in range(0, len(packed), 12):
+            chunk = packed[start:start + 12]
+            lines.append('    ' + ' '.join('0x%02x,' % b for b in chunk))
+        lines.append('};')
+    with open(path, 'w') as f:
+        f.write('\n'.join(lines) + '\n')
+
+
+def command_pack(args):
+    data = contents(args.objcopy, args.first, '.data')
+    packed, stats = pack(data)
+    if unpack(packed, len(data)) != data:
+        sys.exit('pack_data.py: the packed image does not unpack to .data')
+    write_source(args.second, packed, len(data))
+
+    bursts, rest = divmod(len(data), 16)
+    copy = bursts * 10 + rest * 4
+    unpacking = (stats['tokens'] + len(data)) * 6
+    print('.data %u bytes, packed %u: %d bytes of flash saved'
+          % (len(data), len(packed), len(data) - len(packed)))
+    print('  %u tokens, %u literal bytes, %u matches'
+          % (stats['tokens'], stats['literals'], stats['matches']))
+    print('  boot: ~%u cycles to unpack, ~%u to copy, ~%d more (estimate)'
+          % (unpacking, copy, unpacking - copy))
+    if len(packed) >= len(data) and data:
+        print('  the image does not pack, build without HWREG_PACK_DATA')
+
+
+def command_check(args):
+    plain = sections(args.objdump, args.first)
+    final = sections(args.objdump, args.second)
+    failed = []
+    for name, (size, vma, _) in sorted(plain.items()):
+        if name not in final:
+            failed.append('%s is missing' % name)
+        elif final[name][:2] != (size, vma):
+            failed.append('%s has moved or changed its size' % name)
+    if failed:
+        sys.exit('pack_data.py: the packed link differs: ' + ', '.join(failed))
+
+    data = contents(args.objcopy, args.first, '.data')
+    if not data:
+        return
+    packed = contents(args.objcopy, args.second, '.data_packed')
+    if unpack(packed, len(data)) != data:
+        sys.exit('pack_data.py: .data_packed does not unpack to the plain .data')
+
+
+def main():
+    parser = argparse.ArgumentParser(usage=__doc__)
+    parser.add_argument('--objdump', default='arm-none-eabi-objdump')
+    parser.add_argument('--objcopy', default='arm-none-eabi-objcopy')
+    parser.add_argument('command', choices=('pack', 'check'))
+    parser.add_argument('first')
+    parser.add_argument('second')
+    args = parser.parse_args()
+
+    if args.command == 'pack':
+        command_pack(args)
+    else:
+        command_check(args)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+# 2021 Nikolai Chizhov
+
+"""Register headers from a CMSIS-SVD file
+
+Writes one header per register layout into <out>/svd/ and an umbrella
+header <out>/svd/<device>.hpp, everything in namespace svd:
+
+    template <uintptr_t base>
+    struct GPIOA_Regs {
+        /* Port input data register (GPIOn_IDR) */
+        struct IDR : public Register<base + 0x8, 32U, RegisterMode::Read> {
+            static constexpr uint32_t ResetValue = 0x00000000U;
+            using IDR0 = RegisterField<IDR, 0, 1U, RegisterMode::Read>;
+            ...
+        };
+    };
+    using GPIOA = GPIOA_Regs<0x40010800>;
+    using GPIOB = GPIOA_Regs<0x40010C00>;   /* derivedFrom GPIOA */
+
+The layout is kept cheap to compile: peripherals derived from another one
+share its template, and the fields are a flat list of RegisterField aliases,
+which are not instantiated until used. A field named like its register gets
+a trailing underscore (TIM2::CNT::CNT_), the name is taken by the register.
+
+Only changed files are rewritten, so a regeneration doesn't trigger a
+rebuild.
+
+Usage: svd2hpp.py STM32F103.svd <out dir>
+"""
+
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+ACCESS = {
+    'read-only': 'RegisterMode::Read',
+    'write-only': 'RegisterMode::Write',
+    'read-write': 'RegisterMode::RW',
+    'writeOnce': 'RegisterMode::Write',
+    'read-writeOnce': 'RegisterMode::RW',
+}
+
+# members of Register and RegisterField, a field cannot take these names
+RESERVED = {'Address', 'Type', 'Access', 'WriteSemantics', 'Bus',
+            'IsStoreOnly', 'Get', 'Set', 'Toggle', 'Reset', 'SetMasked',
+            'ResetValue', 'FieldMask'}
+
+
+def number(text):
+    text = text.strip().lower()
+    if text.startswith('0x'):
+        return int(text, 16)
+    if text.startswith('#'):
+        return int(text[1:], 2)
+    return int(text, 10)
+
+
+def identifier(name):
+    name = re.sub(r'\W', '_', name.strip())
+    if name[0].isdigit():
+        name = '_' + name
+    return name
+
+
+def comment(text):
+    text = ' '.join((text or '').split())
+    return text.replace('*/', '* /')
+
+
+class Field:
+    def __init__(self, node, access):
+        self.name = identifier(node.findtext('name'))
+        self.description = comment(node.findtext('description'))
+        self.access = node.findtext('access') or access
+        if node.find('bitOffset') is not None:
+            self.offset = number(node.findtext('bitOffset'))
+            self.width = number(node.findtext('bitWidth'))
+        elif node.find('lsb') is not None:
+            self.offset = number(node.findtext('lsb'))
+            self.width = number(node.findtext('msb')) - self.offset + 1
+        else:
+            msb, lsb = re.match(r'\[(\d+):(\d+)\]',
+                                node.findtext('bitRange')).groups()
+            self.offset = int(lsb)
+            self.width = int(msb) - int(lsb) + 1
+
+
+class Reg:
+    def __init__(self, node, defaults):
+        self.name = identifier(node.findtext('name'))
+        self.description = comment(node.findtext('description'))
+        self.offset = number(node.findtext('addressOffset'))
+        self.size = number(node.findtext('size') or defaults['size'])
+        self.access = node.findtext('access') or defaults['access']
+        self.reset = number(node.findtext('resetValue') or defaults['resetValue'])
+        fields = node.find('fields')
+        self.fields = [Field(f, self.access)
+                       for f in (fields.findall('field') if fields is not None else [])]
+        self.fields.sort(key=lambda f: -f.offset)
+
+        for f in self.fields:
+            if f.name == self.name or f.name in RESERVED:
+                f.name += '_'
+            if f.offset + f.width > self.size:
+                raise ValueError('%s.%s is out of the register' % (self.name, f.name))
+
+
+class Peripheral:
+    def __init__(self, node, defaults):
+        self.name = identifier(node.findtext('name'))
+        self.description = comment(node.findtext('description'))
+        self.base = number(node.findtext('baseAddress'))
+        self.derived_from = node.get('derivedFrom')
+        registers = node.find('registers')
+        self.registers = None
+        if registers is not None:
+            local = dict(defaults)
+            for key in ('size', 'access', 'resetValue'):
+                if node.find(key) is not None:
+                    local[key] = node.findtext(key)
+            self.registers = [Reg(r, local) for r in registers.findall('register')]
+            self.registers.sort(key=lambda r: (r.offset, r.name))
+
+
+def render_register(reg):
+    mode = ACCESS[reg.access]
+    semantics = ', RegisterWrite::WriteOnly' if reg.access == 'write-only' else ''
+    mask = 0
+    for f in reg.fields:
+        mask |= ((1 << f.width) - 1) << f.offset
+
+    out = []
+    if reg.description:
+        out.append('    /* %s */' % reg.description)
+    out.append('    struct %s : public Register<base + 0x%X, %uU, %s%s> {'
+               % (reg.name, reg.offset, reg.size, mode, semantics))
+    out.append('        static constexpr uint32_t ResetValue = 0x%08XU;' % reg.reset)
+    out.append('        static constexpr uint32_t FieldMask  = 0x%08XU;' % mask)
+    for f in reg.fields:
+        out.append('        using %s = RegisterField<%s, %u, %uU, %s>;'
+                   % (f.name, reg.name, f.offset, f.width, ACCESS[f.access]))
+    out.append('    };')
+    return out
+
+
+def render_peripheral(device, root, instances):
+    out = ['/* Generated by tools/svd2hpp.py from %s.svd, do not edit */' % device,
+           '',
+           '#pragma once',
+           '',
+           '#include <cstdint>',
+           '',
+           '#include "register.hpp"',
+           '',
+           'namespace svd {',
+           '']
+    if root.description:
+        out.append('/* %s */' % root.description)
+    out.append('template <uintptr_t base>')
+    out.append('struct %s_Regs {' % root.name)
+    for i, reg in enumerate(root.registers):
+        if i:
+            out.append('')
+        out += render_register(reg)
+    out.append('};')
+    out.append('')
+    for p in instances:
+        out.append('using %s = %s_Regs<0x%08X>;' % (p.name, root.name, p.base))
+    out.append('')
+    out.append('} /* namespace svd */')
+    out.append('')
+    return '\n'.join(out)
+
+
+def write_if_changed(path, text):
+    try:
+        with open(path) as f:
+            if f.read() == text:
+                return
+    except FileNotFoundError:
+        pass
+    with open(path, 'w') as f:
+        f.write(text)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    svd, out_dir = sys.argv[1:]
+
+    device_node = ET.parse(svd).getroot()
+    device = identifier(device_node.findtext('name'))
+    defaults = {
+        'size': device_node.findtext('size') or '32',
+        'access': device_node.findtext('access') or 'read-write',
+        'resetValue': device_node.findtext('resetValue') or '0',
+    }
+
+    peripherals = [Peripheral(p, defaults)
+                   for p in device_node.find('peripherals').findall('peripheral')]
+    by_name = {p.name: p for p in peripherals}
+
+    # a derived peripheral with its own registers gets its own template
+    groups = {}
+    for p in peripherals:
+        root = p if p.registers is not None else by_name[p.derived_from]
+        groups.setdefault(root.name, (root, []))[1].append(p)
+
+    svd_dir = os.path.join(out_dir, 'svd')
+    os.makedirs(svd_dir, exist_ok=True)
+
+    headers = []
+    for name, (root, instances) in groups.items():
+        header = name.lower() + '.hpp'
+        write_if_changed(os.path.join(svd_dir, header),
+                         render_peripheral(device, root, instances))
+        headers.append(header)
+
+    umbrella = ['/* Generated by tools/svd2hpp.py from %s.svd, do not edit */' % device,
+                '',
+                '/* The whole device, %u peripherals */' % len(peripherals),
+                '',
+                '#pragma once',
+                '']
+    umbrella += ['#include "%s"' % h for h in headers]
+    umbrella.append('')
+    write_if_changed(os.path.join(svd_dir, device.lower() + '.hpp'), '\n'.join(umbrella))
+
+
+if __name__ == '__main__':
+    main()